@@ -1,6 +1,7 @@
 QT = core network
 
 CONFIG += c++17
+# 改为c++20即可启用可选的协程接口（CUVCoroutine.h、CUVCoTcp.h）
 
 QMAKE_CXXFLAGS += /utf-8 /wd4200
 
@@ -24,23 +25,56 @@ LIBS += -lpaho-mqtt3as -lpaho-mqtt3a -lpaho-mqttpp3
 
 
 HEADERS += \
+    common/network/base/CLatencyHistogram.h \
+    common/network/base/CUVBufferPool.h \
+    common/network/base/CUVChannel.h \
+    common/network/base/CUVCoroutine.h \
+    common/network/base/CUVFuture.h \
     common/network/base/CUVLoop.h \
+    common/network/base/CUVLoopPool.h \
+    common/network/base/CUVSlotMap.h \
+    common/network/base/CUVTask.h \
+    common/network/base/CUVTimingWheel.h \
+    common/network/base/CUVWorkerPool.h \
     common/network/base/INetworkManager.h \
     common/network/base/NetworkType.h \
     common/network/impl/CNetworkManager.h \
     common/network/impl/mqttClient/CMqttMessage.h \
     common/network/impl/mqttClient/CPahoMqttClient.h \
+    common/network/impl/tcp/CUVCoTcp.h \
     common/network/impl/tcp/CUVTcpClient.h \
     common/network/impl/tcp/CUVTcpServer.h \
 
 SOURCES += \
+    common/network/base/CUVBufferPool.cpp \
+    common/network/base/CUVChannel.cpp \
+    common/network/base/CUVFuture.cpp \
     common/network/base/CUVLoop.cpp \
+    common/network/base/CUVLoopPool.cpp \
+    common/network/base/CUVTimingWheel.cpp \
+    common/network/base/CUVWorkerPool.cpp \
     common/network/impl/CNetworkManager.cpp \
     common/network/impl/mqttClient/CPahoMqttClient.cpp \
+    common/network/impl/tcp/CUVCoTcp.cpp \
     common/network/impl/tcp/CUVTcpClient.cpp \
     common/network/impl/tcp/CUVTcpServer.cpp \
     main.cpp
 
+# 基准测试：qmake CONFIG+=network_benchmark 时编译，
+# 会替换全局operator new以统计分配次数，正式程序中不启用
+network_benchmark {
+    DEFINES += NETWORK_BENCHMARK
+    HEADERS += bench/NetworkBenchmark.h
+    SOURCES += bench/NetworkBenchmark.cpp
+}
+
+# 基础数据结构测试：qmake CONFIG+=network_test 时编译，启动时先运行测试，失败则退出
+network_test {
+    DEFINES += NETWORK_TEST
+    HEADERS += test/NetworkUnitTest.h
+    SOURCES += test/NetworkUnitTest.cpp
+}
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
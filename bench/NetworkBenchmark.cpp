@@ -0,0 +1,666 @@
+#include "NetworkBenchmark.h"
+
+#include "common/network/base/CUVChannel.h"
+#include "common/network/base/CUVLoopPool.h"
+#include "common/network/base/CUVSlotMap.h"
+#include "common/network/impl/tcp/CUVTcpClient.h"
+#include "common/network/impl/tcp/CUVTcpServer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 全局堆分配计数，用于基准测试统计每个任务的分配次数
+static std::atomic<uint64_t> g_allocationCount(0);
+
+// 基准测试中保存缓冲区地址，避免编译器省略测试的分配
+static char* volatile g_bufferSink = nullptr;
+
+void* operator new(std::size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+// 一次基准测试的测量结果
+struct BenchResult
+{
+    double elapsedNs;     // 总耗时，单位纳秒
+    uint64_t allocations; // 期间的堆分配次数
+};
+
+// 计时执行一段基准测试代码，同时统计期间的堆分配次数
+template<typename Func>
+BenchResult measure(Func&& func)
+{
+    uint64_t allocationsBefore = g_allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    return BenchResult{static_cast<double>(elapsed.count()),
+                       g_allocationCount.load() - allocationsBefore};
+}
+
+// 让出CPU直到计数达到目标值
+template<typename Counter, typename Value>
+void waitUntil(const Counter& counter, Value target)
+{
+    while (counter.load() < target) {
+        std::this_thread::yield();
+    }
+}
+
+// 输出每个操作的平均耗时和分配次数，调用者可以接着输出附加统计并换行
+std::ostream& report(const std::string& name, const BenchResult& result, uint64_t count, const char* unit)
+{
+    return std::cout << name << ": " << result.elapsedNs / count << " ns/" << unit << ", "
+                     << static_cast<double>(result.allocations) / count << " allocations/" << unit;
+}
+
+} // namespace
+
+int benchTaskAllocation()
+{
+    using namespace Common::Network;
+
+    CUVLoop* loop = CUVLoopPool::getInstance()->getLoop(0);
+    const int taskCount = 200000;
+    std::atomic<int> executed(0);
+
+    // 投递taskCount个捕获了64字节负载的任务，统计分配次数和耗时
+    auto run = [&](const char* name, auto&& post) {
+        std::vector<std::string> payloads(taskCount, std::string(64, 'x'));
+        executed.store(0);
+
+        CUVLoop::Stats statsBefore = loop->getStats();
+        BenchResult result = measure([&]() {
+            for (int i = 0; i < taskCount; ++i) {
+                post(std::move(payloads[i]));
+            }
+            waitUntil(executed, taskCount);
+        });
+        CUVLoop::Stats statsAfter = loop->getStats();
+
+        report(name, result, taskCount, "task")
+            << ", " << statsAfter.wakeups - statsBefore.wakeups << " wakeups, "
+            << statsAfter.drains - statsBefore.drains << " drains" << std::endl;
+    };
+
+    run("std::function", [&](std::string&& payload) {
+        loop->postTask(std::function<void()>([&executed, payload = std::move(payload)]() {
+            (void) payload;
+            executed.fetch_add(1);
+        }));
+    });
+
+    run("CUVTask", [&](std::string&& payload) {
+        loop->postTask([&executed, payload = std::move(payload)]() {
+            (void) payload;
+            executed.fetch_add(1);
+        });
+    });
+
+    return 0;
+}
+
+int benchProducerToken()
+{
+    using namespace Common::Network;
+
+    CUVLoop* loop = CUVLoopPool::getInstance()->getLoop(0);
+    const int taskCount = 1000000;
+    const int bulkSize = 64;
+    std::atomic<int> executed(0);
+
+    // 投递taskCount个空任务，统计每个任务的平均耗时
+    auto run = [&](const char* name, auto&& postAll) {
+        executed.store(0);
+        BenchResult result = measure([&]() {
+            postAll();
+            waitUntil(executed, taskCount);
+        });
+        report(name, result, taskCount, "task") << std::endl;
+    };
+
+    run("implicit producer", [&]() {
+        for (int i = 0; i < taskCount; ++i) {
+            loop->postTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        }
+    });
+
+    auto producer = loop->createProducer();
+    run("producer token", [&]() {
+        for (int i = 0; i < taskCount; ++i) {
+            producer->post([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        }
+    });
+
+    run("producer token bulk", [&]() {
+        std::vector<CUVTask> batch(bulkSize);
+        for (int i = 0; i < taskCount; i += bulkSize) {
+            for (auto& task : batch) {
+                task = CUVTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+            }
+            producer->postBulk(batch.data(), batch.size());
+        }
+    });
+
+    return 0;
+}
+
+int benchSubmit()
+{
+    using namespace Common::Network;
+
+    CUVLoopPool* pool = CUVLoopPool::getInstance();
+    const int roundCount = 2000;
+    const size_t loopCount = pool->size();
+
+    // 每轮向所有循环各提交一个计算任务并等待全部结果，统计分配次数和每轮耗时
+    auto run = [&](const char* name, auto&& fanOut) {
+        long long checksum = 0;
+        BenchResult result = measure([&]() {
+            for (int round = 0; round < roundCount; ++round) {
+                checksum += fanOut(round);
+            }
+        });
+        report(name, result, roundCount * loopCount, "task")
+            << ", checksum " << checksum << std::endl;
+    };
+
+    run("std::packaged_task", [&](int round) {
+        std::vector<std::future<long long>> futures;
+        futures.reserve(loopCount);
+        for (size_t i = 0; i < loopCount; ++i) {
+            auto task = std::make_shared<std::packaged_task<long long()>>(
+                [round, i]() { return static_cast<long long>(round) * static_cast<long long>(i); });
+            futures.push_back(task->get_future());
+            pool->getLoop(i)->postTask([task]() { (*task)(); });
+        }
+        long long sum = 0;
+        for (auto& future : futures) {
+            sum += future.get();
+        }
+        return sum;
+    });
+
+    size_t dropped = 0;
+    run("CUVLoop::submit", [&](int round) {
+        std::vector<CUVFuture<long long>> futures;
+        futures.reserve(loopCount);
+        for (size_t i = 0; i < loopCount; ++i) {
+            futures.push_back(pool->getLoop(i)->submit(
+                [round, i]() { return static_cast<long long>(round) * static_cast<long long>(i); }));
+        }
+        long long sum = 0;
+        for (auto& future : futures) {
+            if (std::optional<long long> value = future.get()) {
+                sum += *value;
+            } else {
+                ++dropped;
+            }
+        }
+        return sum;
+    });
+
+    // 被丢弃的提交没有结果，校验和不可信
+    if (dropped > 0) {
+        std::cout << "benchSubmit: " << dropped << " tasks dropped" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int benchChannel()
+{
+    using namespace Common::Network;
+
+    // 转发的消息：分片收到的数据转给MQTT发布循环
+    struct ForwardMessage
+    {
+        uint64_t connectionId = 0;
+        uint32_t topic = 0;
+        uint32_t length = 0;
+    };
+
+    CUVLoop* target = CUVLoopPool::getInstance()->getLoop(0);
+    const uint64_t messageCount = 1000000;
+    std::atomic<uint64_t> received(0);
+    auto handle = [&received](const ForwardMessage& message) {
+        received.fetch_add(message.length > 0 ? 1 : 0, std::memory_order_relaxed);
+    };
+
+    // 从另一个线程转发messageCount条消息，统计分配次数、耗时和唤醒次数
+    auto run = [&](const char* name, auto&& forward, auto&& wakeups) {
+        received.store(0);
+        uint64_t wakeupsBefore = wakeups();
+        BenchResult result = measure([&]() {
+            std::thread producer([&]() {
+                for (uint64_t i = 0; i < messageCount; ++i) {
+                    while (!forward(ForwardMessage{i, static_cast<uint32_t>(i & 7), 64})) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            producer.join();
+            waitUntil(received, messageCount);
+        });
+        report(name, result, messageCount, "message")
+            << ", " << wakeups() - wakeupsBefore << " wakeups" << std::endl;
+    };
+
+    run(
+        "postTask(std::function)",
+        [&](const ForwardMessage& message) {
+            return target->postTask(
+                std::function<void()>([&handle, message]() { handle(message); }));
+        },
+        [&]() { return target->getStats().wakeups; });
+
+    CUVMpscChannel<ForwardMessage> mpsc(target, [&](ForwardMessage& message) { handle(message); });
+    auto sender = mpsc.createSender();
+    run(
+        "CUVMpscChannel",
+        [&](const ForwardMessage& message) { return sender->send(message); },
+        [&]() { return mpsc.getStats().wakeups; });
+
+    CUVSpscChannel<ForwardMessage> spsc(target, 4096, [&](ForwardMessage& message) {
+        handle(message);
+    });
+    run(
+        "CUVSpscChannel",
+        [&](const ForwardMessage& message) { return spsc.send(message); },
+        [&]() { return spsc.getStats().wakeups; });
+
+    return 0;
+}
+
+int benchReadBuffer()
+{
+    using namespace Common::Network;
+
+    CUVLoop* loop = CUVLoopPool::getInstance()->getLoop(0);
+    const int readCount = 200000;
+    const int connectionCount = 64;
+
+    // 在循环线程中模拟connectionCount个连接轮流读取，每次读取readSize字节，统计分配次数和耗时
+    auto run = [&](const char* name, size_t readSize, auto&& read) {
+        BenchResult result = measure([&]() {
+            loop->submit([&]() {
+                    for (int i = 0; i < readCount; ++i) {
+                        read(i % connectionCount, readSize);
+                    }
+                })
+                .wait();
+        });
+        report(std::string(name) + " (" + std::to_string(readSize) + " bytes/read)",
+               result,
+               readCount,
+               "read")
+            << std::endl;
+    };
+
+    // 原实现：每次读取new一个libuv建议的64KB缓冲区，回调后delete
+    auto newDelete = [](int, size_t readSize) {
+        char* buffer = new char[65536];
+        std::memset(buffer, 0, readSize);
+        g_bufferSink = buffer;
+        delete[] buffer;
+    };
+
+    // 缓冲池：按连接的读取大小估计取用缓冲区
+    std::vector<CUVBufferPool::ReadSizeEstimator> estimators(connectionCount);
+    CUVBufferPool* pool = loop->getBufferPool();
+    auto pooled = [&](int connection, size_t readSize) {
+        size_t capacity = 0;
+        char* buffer = pool->acquire(estimators[connection].next(), &capacity);
+        size_t nread = (std::min) (readSize, capacity);
+        std::memset(buffer, 0, nread);
+        g_bufferSink = buffer;
+        estimators[connection].record(nread, capacity);
+        pool->release(buffer);
+    };
+
+    for (size_t readSize : {size_t(128), size_t(65536)}) {
+        run("new char[65536]", readSize, newDelete);
+        run("CUVBufferPool", readSize, pooled);
+    }
+
+    CUVBufferPool::Stats stats = pool->getStats();
+    std::cout << "CUVBufferPool: hit rate " << stats.hitRate * 100 << "%, resident "
+              << stats.residentBytes << " bytes, cached " << stats.cachedBytes << " bytes"
+              << std::endl;
+
+    return 0;
+}
+
+int benchReceivePath()
+{
+    using namespace Common::Network;
+
+    CUVLoop serverLoop;
+    CUVLoop clientLoop;
+    const int messageCount = 20000;
+    const size_t messageSize = 64;
+    int port = 40010;
+
+    // 客户端发送messageCount条消息，统计服务器每次读取的分配次数和整体耗时
+    auto run = [&](const char* name, auto&& setCallback) {
+        std::atomic<uint64_t> receivedBytes(0);
+        std::atomic<uint64_t> chunks(0);
+        auto onData = [&](size_t length) {
+            receivedBytes.fetch_add(length, std::memory_order_relaxed);
+            chunks.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        CUVTcpServer server(&serverLoop);
+        setCallback(server, onData);
+        server.listen("127.0.0.1", port);
+
+        CUVTcpClient client(&clientLoop);
+        std::promise<bool> connected;
+        client.setConnectCallback([&](bool success, const std::string&) {
+            connected.set_value(success);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        client.connect("127.0.0.1", port++);
+        if (!connected.get_future().get()) {
+            std::cout << name << ": connect failed" << std::endl;
+            return;
+        }
+
+        BenchResult result = measure([&]() {
+            for (int i = 0; i < messageCount; ++i) {
+                client.send(std::string(messageSize, 'x'));
+            }
+            waitUntil(receivedBytes, messageCount * messageSize);
+        });
+        report(name, result, messageCount, "message") << ", " << chunks.load() << " reads"
+                                                      << std::endl;
+
+        client.disconnect();
+        server.stop();
+    };
+
+    run("std::string callback", [](CUVTcpServer& server, auto& onData) {
+        server.setReceiveCallback(
+            [&onData](const Address&, const std::string& data) { onData(data.size()); });
+    });
+
+    run("view callback", [](CUVTcpServer& server, auto& onData) {
+        server.setDataCallback([&onData](CUVTcpServer::ConnectionId, const char*, size_t length) {
+            onData(length);
+        });
+    });
+
+    run("buffer callback", [](CUVTcpServer& server, auto& onData) {
+        server.setBufferCallback(
+            [&onData](CUVTcpServer::ConnectionId, CUVBufferPool::Buffer&& buffer) {
+                onData(buffer.size());
+            });
+    });
+
+    return 0;
+}
+
+int benchConnectionLookup()
+{
+    using namespace Common::Network;
+
+    const int connectionCount = 10000;
+    const int lookupCount = 2000000;
+
+    // 原实现：以IP和端口为键的哈希表，每次查找哈希一个std::string
+    std::unordered_map<Address, int> addressMap;
+    std::vector<Address> addresses;
+    // 槽位表：以连接ID为键，先插入再删除一半，模拟连接断开后槽位复用
+    CUVSlotMap<int> slotMap;
+    std::vector<CUVSlotMap<int>::Key> keys;
+    for (int i = 0; i < connectionCount; ++i) {
+        Address address{"192.168." + std::to_string(i / 250) + "." + std::to_string(i % 250),
+                        30000 + i};
+        addressMap[address] = i;
+        addresses.push_back(address);
+        keys.push_back(slotMap.insert(i));
+    }
+    for (int i = 0; i < connectionCount; i += 2) {
+        slotMap.erase(keys[i]);
+        keys[i] = slotMap.insert(i);
+    }
+
+    auto run = [&](const char* name, auto&& lookup) {
+        int64_t sum = 0;
+        BenchResult result = measure([&]() {
+            for (int i = 0; i < lookupCount; ++i) {
+                sum += lookup(i % connectionCount);
+            }
+        });
+        report(name, result, lookupCount, "lookup") << ", checksum " << sum << std::endl;
+    };
+
+    run("unordered_map<Address>", [&](int i) { return addressMap.find(addresses[i])->second; });
+    run("CUVSlotMap", [&](int i) { return *slotMap.find(keys[i]); });
+
+    return 0;
+}
+
+int benchWriteCoalescing()
+{
+    using namespace Common::Network;
+
+    CUVLoop serverLoop;
+    CUVLoop clientLoop;
+    const int burstCount = 2000;
+    const int burstSize = 50; // 与testTcpClient()中每次连续发送的消息数相同
+    const size_t messageSize = 32;
+    const uint64_t totalBytes = uint64_t(burstCount) * burstSize * messageSize;
+
+    std::atomic<uint64_t> serverBytes(0);
+    std::atomic<uint64_t> serverReads(0);
+    std::atomic<uint64_t> serverSendCallbacks(0);
+    std::atomic<CUVTcpServer::ConnectionId> connectionId(0);
+    CUVTcpServer server(&serverLoop);
+    server.setConnectCallback([&](const Address& clientAddr, bool success, const std::string&) {
+        if (success) {
+            connectionId.store(clientAddr.connectionId);
+        }
+    });
+    server.setDataCallback([&](CUVTcpServer::ConnectionId, const char*, size_t length) {
+        serverBytes.fetch_add(length, std::memory_order_relaxed);
+        serverReads.fetch_add(1, std::memory_order_relaxed);
+    });
+    server.setSendCallback([&](const Address&, bool, const std::string&) {
+        serverSendCallbacks.fetch_add(1, std::memory_order_relaxed);
+    });
+    server.listen("127.0.0.1", 40020);
+
+    std::atomic<uint64_t> clientBytes(0);
+    std::atomic<uint64_t> clientReads(0);
+    CUVTcpClient client(&clientLoop);
+    std::promise<bool> connected;
+    client.setConnectCallback([&](bool success, const std::string&) {
+        connected.set_value(success);
+    });
+    client.setReceiveCallback([&](const char*, size_t length) {
+        clientBytes.fetch_add(length, std::memory_order_relaxed);
+        clientReads.fetch_add(1, std::memory_order_relaxed);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    client.connect("127.0.0.1", 40020);
+    if (!connected.get_future().get()) {
+        std::cout << "benchWriteCoalescing: connect failed" << std::endl;
+        return 1;
+    }
+    while (connectionId.load() == 0) {
+        std::this_thread::yield();
+    }
+
+    // 每个突发在事件循环线程中一次投递，同一轮循环中的发送合并为一次写请求
+    auto run = [&](const char* name, CUVLoop& loop, auto&& sendOne, auto& bytes, auto& reads) {
+        BenchResult result = measure([&]() {
+            for (int i = 0; i < burstCount; ++i) {
+                loop.postTask([&]() {
+                    for (int j = 0; j < burstSize; ++j) {
+                        sendOne(std::string(messageSize, 'x'));
+                    }
+                });
+                // 等待上一个突发到达，避免写队列超出客户端的上限
+                waitUntil(bytes, uint64_t(i) * burstSize * messageSize);
+            }
+            waitUntil(bytes, totalBytes);
+        });
+        report(name, result, burstCount * burstSize, "message")
+            << ", " << static_cast<double>(reads.load()) / burstCount << " reads/burst"
+            << std::endl;
+    };
+
+    run("client -> server",
+        clientLoop,
+        [&](std::string&& data) { client.send(std::move(data)); },
+        serverBytes,
+        serverReads);
+    run("server -> client",
+        serverLoop,
+        [&](std::string&& data) { server.send(connectionId.load(), std::move(data)); },
+        clientBytes,
+        clientReads);
+    std::cout << "server send callbacks: " << serverSendCallbacks.load() << std::endl;
+
+    client.disconnect();
+    server.stop();
+    return 0;
+}
+
+int benchRequestResponse()
+{
+    using namespace Common::Network;
+
+    CUVLoop serverLoop;
+    CUVLoop clientLoop;
+    const int roundTrips = 20000;
+    const std::string request(64, 'q');
+
+    // 服务器在接收回调中原样回复，回复在循环末尾直接写入套接字
+    CUVTcpServer server(&serverLoop);
+    server.setDataCallback(
+        [&server](CUVTcpServer::ConnectionId id, const char* data, size_t length) {
+            server.send(id, std::string(data, length));
+        });
+    server.listen("127.0.0.1", 40030);
+
+    // 客户端收到完整回复后在接收回调中发出下一个请求
+    CUVTcpClient client(&clientLoop);
+    std::promise<bool> connected;
+    std::promise<void> finished;
+    size_t pendingBytes = 0;
+    int remaining = roundTrips;
+    client.setConnectCallback([&](bool success, const std::string&) {
+        connected.set_value(success);
+    });
+    client.setReceiveCallback([&](const char*, size_t length) {
+        pendingBytes -= length;
+        if (pendingBytes > 0) {
+            return;
+        }
+        if (--remaining == 0) {
+            finished.set_value();
+            return;
+        }
+        pendingBytes = request.size();
+        client.send(request);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    client.connect("127.0.0.1", 40030);
+    if (!connected.get_future().get()) {
+        std::cout << "benchRequestResponse: connect failed" << std::endl;
+        return 1;
+    }
+
+    BenchResult result = measure([&]() {
+        clientLoop.postTask([&]() {
+            pendingBytes = request.size();
+            client.send(request);
+        });
+        finished.get_future().wait();
+    });
+
+    CUVTcpClient::SendStats clientStats = client.getSendStats();
+    uint64_t serverImmediate = 0;
+    uint64_t serverQueued = 0;
+    for (const CUVTcpServer::ShardStats& stats : server.getShardStats()) {
+        serverImmediate += stats.immediateBytes;
+        serverQueued += stats.queuedBytes;
+    }
+    report("round trip", result, roundTrips, "round trip") << std::endl;
+    std::cout << "client: " << clientStats.immediateBytes << " immediate bytes, "
+              << clientStats.queuedBytes << " queued bytes" << std::endl;
+    std::cout << "server: " << serverImmediate << " immediate bytes, " << serverQueued
+              << " queued bytes" << std::endl;
+
+    client.disconnect();
+    server.stop();
+    return 0;
+}
+
+int benchBusyPoll()
+{
+    using namespace Common::Network;
+
+    const int sampleCount = 20000;
+    const auto interval = std::chrono::microseconds(200);
+
+    // 按固定间隔向空闲的循环投递空任务，任务排队时间即唤醒到处理的延迟
+    auto run = [&](const char* name, bool busyPoll) {
+        CUVLoop::Config config;
+        config.threadName = busyPoll ? "busy-poll" : "blocking";
+        config.metricsEnabled = true;
+        config.busyPoll = busyPoll;
+        CUVLoop loop(config);
+
+        std::atomic<int> executed(0);
+        loop.getMetrics();
+        for (int i = 0; i < sampleCount; ++i) {
+            loop.postTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+            std::this_thread::sleep_for(interval);
+        }
+        waitUntil(executed, sampleCount);
+
+        CUVLoop::Metrics metrics = loop.getMetrics();
+        CUVLoop::Stats stats = loop.getStats();
+        std::cout << name << ": wakeup-to-handler p50 " << metrics.queueWait.p50 / 1000.0
+                  << " us, p99 " << metrics.queueWait.p99 / 1000.0 << " us, max "
+                  << metrics.queueWait.max / 1000.0 << " us, " << stats.wakeups << " wakeups, "
+                  << stats.busyPollBlocks << " blocking polls" << std::endl;
+    };
+
+    run("blocking", false);
+    run("busy-poll", true);
+
+    return 0;
+}
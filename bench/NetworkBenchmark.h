@@ -0,0 +1,18 @@
+#ifndef NETWORKBENCHMARK_H
+#define NETWORKBENCHMARK_H
+
+// 网络组件基准测试，仅在qmake CONFIG+=network_benchmark时编译；
+// 所在翻译单元替换了全局operator new以统计分配次数，不进入正式程序
+
+int benchTaskAllocation();   // 任务投递分配
+int benchProducerToken();    // 生产者令牌
+int benchSubmit();           // 有返回值任务提交
+int benchChannel();          // 跨循环通道
+int benchReadBuffer();       // 读缓冲池
+int benchReceivePath();      // 服务器接收路径
+int benchConnectionLookup(); // 连接查找
+int benchWriteCoalescing();  // 合并写出
+int benchRequestResponse();  // 请求应答往返
+int benchBusyPoll();         // 忙轮询唤醒延迟
+
+#endif // NETWORKBENCHMARK_H
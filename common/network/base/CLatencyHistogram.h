@@ -0,0 +1,186 @@
+#ifndef CLATENCYHISTOGRAM_H
+#define CLATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 对数线性分桶的延迟直方图（HDR风格）
+ * @details 每个2的幂区间再等分为kSubBuckets个子桶，相对误差不超过1/kSubBuckets，
+ *          可覆盖完整的uint64_t取值范围；
+ *          记录操作只使用relaxed原子操作，可在事件循环线程中高频调用，其他线程可随时读取快照
+ */
+class CLatencyHistogram
+{
+public:
+    static constexpr size_t kSubBucketBits = 4;                                 // 子桶位数
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;          // 每个区间的子桶数
+    static constexpr size_t kBucketCount = (65 - kSubBucketBits) * kSubBuckets; // 总桶数
+
+    /**
+     * @brief 直方图快照
+     */
+    struct Snapshot
+    {
+        uint64_t count; // 样本数
+        uint64_t mean;  // 平均值
+        uint64_t max;   // 最大值
+        uint64_t p50;   // 50分位值
+        uint64_t p90;   // 90分位值
+        uint64_t p99;   // 99分位值
+        uint64_t p999;  // 99.9分位值
+    };
+
+    CLatencyHistogram()
+        : m_count(0)
+        , m_sum(0)
+        , m_max(0)
+    {
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            m_buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 禁止拷贝
+    CLatencyHistogram(const CLatencyHistogram &) = delete;
+    CLatencyHistogram &operator=(const CLatencyHistogram &) = delete;
+
+    /**
+     * @brief 记录一个样本
+     * @param value 样本值
+     */
+    void record(uint64_t value)
+    {
+        m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief 获取快照
+     * @param reset 是否在读取的同时清零，用于按周期采集区间统计
+     * @return 快照，分位值为所在桶的中点
+     */
+    Snapshot snapshot(bool reset = false)
+    {
+        uint64_t counts[kBucketCount];
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = reset ? m_buckets[i].exchange(0, std::memory_order_relaxed)
+                              : m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        uint64_t sum = reset ? m_sum.exchange(0, std::memory_order_relaxed)
+                             : m_sum.load(std::memory_order_relaxed);
+        uint64_t max = reset ? m_max.exchange(0, std::memory_order_relaxed)
+                             : m_max.load(std::memory_order_relaxed);
+        if (reset) {
+            m_count.exchange(0, std::memory_order_relaxed);
+        }
+
+        Snapshot result{};
+        result.count = total;
+        result.max = max;
+        if (total == 0) {
+            return result;
+        }
+        result.mean = sum / total;
+        result.p50 = percentile(counts, total, 0.5, max);
+        result.p90 = percentile(counts, total, 0.9, max);
+        result.p99 = percentile(counts, total, 0.99, max);
+        result.p999 = percentile(counts, total, 0.999, max);
+        return result;
+    }
+
+    /**
+     * @brief 获取样本总数
+     */
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+private:
+    // 计算样本值所在的桶
+    static size_t bucketIndex(uint64_t value)
+    {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        size_t exponent = 63 - countLeadingZeros(value);
+        size_t subBucket = static_cast<size_t>(value >> (exponent - kSubBucketBits)) - kSubBuckets;
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+    }
+
+    // 计算桶的下界
+    static uint64_t bucketLowerBound(size_t index)
+    {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        size_t exponent = index / kSubBuckets + kSubBucketBits - 1;
+        uint64_t subBucket = index % kSubBuckets + kSubBuckets;
+        return subBucket << (exponent - kSubBucketBits);
+    }
+
+    // 计算桶的中点
+    static uint64_t bucketMidpoint(size_t index)
+    {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        size_t exponent = index / kSubBuckets + kSubBucketBits - 1;
+        return bucketLowerBound(index) + ((uint64_t(1) << (exponent - kSubBucketBits)) >> 1);
+    }
+
+    // 计算分位值
+    static uint64_t percentile(const uint64_t *counts, uint64_t total, double ratio, uint64_t max)
+    {
+        uint64_t target = static_cast<uint64_t>(total * ratio);
+        if (target == 0) {
+            target = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                uint64_t value = bucketMidpoint(i);
+                return value < max ? value : max;
+            }
+        }
+        return max;
+    }
+
+    // 计算前导零个数，value不为0
+    static size_t countLeadingZeros(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - index;
+#else
+        return static_cast<size_t>(__builtin_clzll(value));
+#endif
+    }
+
+private:
+    std::atomic<uint64_t> m_buckets[kBucketCount]; // 各桶的样本数
+    std::atomic<uint64_t> m_count;                 // 样本总数
+    std::atomic<uint64_t> m_sum;                   // 样本值之和
+    std::atomic<uint64_t> m_max;                   // 最大值
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CLATENCYHISTOGRAM_H
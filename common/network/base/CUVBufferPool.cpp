@@ -0,0 +1,244 @@
+#include "CUVBufferPool.h"
+#include <new>
+#include <utility>
+
+using namespace Common::Network;
+
+namespace {
+
+// 缓冲区头部大小，保持数据区按最大基本类型对齐；头部开头记录尺寸等级
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+// 每次从归还队列中回收的最大缓冲区数
+constexpr size_t kCollectBatchSize = 64;
+
+} // namespace
+
+// 记录一次读取
+void CUVBufferPool::ReadSizeEstimator::record(size_t nread, size_t capacity)
+{
+    // 读满缓冲区说明可能还有数据，升一级
+    if (nread >= capacity) {
+        if (m_sizeClass + 1u < kSizeClassCount) {
+            ++m_sizeClass;
+        }
+        m_smallReads = 0;
+        return;
+    }
+
+    // 连续小读取达到次数后降一级，偶尔的小读取不影响
+    if (m_sizeClass > 0 && nread <= kSizeClasses[m_sizeClass - 1]) {
+        if (++m_smallReads >= kShrinkAfter) {
+            --m_sizeClass;
+            m_smallReads = 0;
+        }
+    } else {
+        m_smallReads = 0;
+    }
+}
+
+// 构造函数
+CUVBufferPool::Buffer::Buffer(std::shared_ptr<CUVBufferPool> pool, char *data, size_t size)
+    : m_pool(std::move(pool))
+    , m_data(data)
+    , m_size(size)
+{}
+
+// 移动构造函数
+CUVBufferPool::Buffer::Buffer(Buffer &&other) noexcept
+    : m_pool(std::move(other.m_pool))
+    , m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+{}
+
+// 移动赋值
+CUVBufferPool::Buffer &CUVBufferPool::Buffer::operator=(Buffer &&other) noexcept
+{
+    if (this != &other) {
+        reset();
+        m_pool = std::move(other.m_pool);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+// 缓冲区容量
+size_t CUVBufferPool::Buffer::capacity() const
+{
+    return m_data ? capacityOf(m_data) : 0;
+}
+
+// 归还缓冲区
+void CUVBufferPool::Buffer::reset()
+{
+    if (m_data) {
+        m_pool->release(m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+    m_pool.reset();
+}
+
+// 构造函数
+CUVBufferPool::CUVBufferPool(size_t maxCachedBytes)
+    : m_acquireCount(0)
+    , m_hitCount(0)
+    , m_remoteReleaseCount(0)
+    , m_residentBytes(0)
+    , m_cachedBytes(0)
+{
+    for (size_t i = 0; i < kSizeClassCount; ++i) {
+        m_maxCachedCount[i] = maxCachedBytes / kSizeClasses[i];
+    }
+}
+
+// 析构函数，释放缓存的缓冲区；使用中的缓冲区由Buffer持有缓冲池的引用，此时已全部归还
+CUVBufferPool::~CUVBufferPool()
+{
+    char *data = nullptr;
+    while (m_returned.try_dequeue(data)) {
+        deallocate(data, sizeClassOf(data));
+    }
+
+    for (size_t i = 0; i < kSizeClassCount; ++i) {
+        for (char *cached : m_freeLists[i]) {
+            deallocate(cached, i);
+        }
+        m_freeLists[i].clear();
+    }
+}
+
+// 设置所属事件循环线程
+void CUVBufferPool::setOwnerThread(std::thread::id threadId)
+{
+    m_ownerThread = threadId;
+}
+
+// 取用缓冲区
+char *CUVBufferPool::acquire(size_t size, size_t *capacity)
+{
+    size_t sizeClass = sizeClassOf(size);
+    std::vector<char *> &freeList = m_freeLists[sizeClass];
+    m_acquireCount.fetch_add(1, std::memory_order_relaxed);
+    if (capacity) {
+        *capacity = kSizeClasses[sizeClass];
+    }
+
+    // 本等级没有空闲缓冲区时先回收其他线程归还的缓冲区
+    if (freeList.empty() && m_returned.size_approx() > 0) {
+        collectReturned();
+    }
+    if (freeList.empty()) {
+        return allocate(sizeClass);
+    }
+
+    char *data = freeList.back();
+    freeList.pop_back();
+    m_hitCount.fetch_add(1, std::memory_order_relaxed);
+    m_cachedBytes.fetch_sub(kSizeClasses[sizeClass], std::memory_order_relaxed);
+    return data;
+}
+
+// 归还缓冲区
+void CUVBufferPool::release(char *data)
+{
+    if (!data) {
+        return;
+    }
+
+    if (std::this_thread::get_id() == m_ownerThread) {
+        recycle(data, sizeClassOf(data));
+        return;
+    }
+
+    m_remoteReleaseCount.fetch_add(1, std::memory_order_relaxed);
+    m_cachedBytes.fetch_add(capacityOf(data), std::memory_order_relaxed);
+    m_returned.enqueue(data);
+}
+
+// 包装为独占所有权
+CUVBufferPool::Buffer CUVBufferPool::adopt(char *data, size_t size)
+{
+    return Buffer(shared_from_this(), data, size);
+}
+
+// 获取缓冲区的容量
+size_t CUVBufferPool::capacityOf(const char *data)
+{
+    return kSizeClasses[sizeClassOf(data)];
+}
+
+// 获取统计信息
+CUVBufferPool::Stats CUVBufferPool::getStats() const
+{
+    Stats stats;
+    stats.acquires = m_acquireCount.load(std::memory_order_relaxed);
+    stats.hits = m_hitCount.load(std::memory_order_relaxed);
+    stats.hitRate = stats.acquires > 0 ? static_cast<double>(stats.hits) / stats.acquires : 0.0;
+    stats.remoteReleases = m_remoteReleaseCount.load(std::memory_order_relaxed);
+    stats.residentBytes = m_residentBytes.load(std::memory_order_relaxed);
+    stats.cachedBytes = m_cachedBytes.load(std::memory_order_relaxed);
+    stats.inUseBytes = stats.residentBytes > stats.cachedBytes
+                           ? stats.residentBytes - stats.cachedBytes
+                           : 0;
+    return stats;
+}
+
+// 选择能容纳size的最小尺寸等级
+size_t CUVBufferPool::sizeClassOf(size_t size)
+{
+    for (size_t i = 0; i < kSizeClassCount; ++i) {
+        if (size <= kSizeClasses[i]) {
+            return i;
+        }
+    }
+    return kSizeClassCount - 1;
+}
+
+// 从缓冲区头部读取尺寸等级
+size_t CUVBufferPool::sizeClassOf(const char *data)
+{
+    return *reinterpret_cast<const uint32_t *>(data - kHeaderSize);
+}
+
+// 从堆分配一个缓冲区
+char *CUVBufferPool::allocate(size_t sizeClass)
+{
+    char *block = static_cast<char *>(::operator new(kHeaderSize + kSizeClasses[sizeClass]));
+    *reinterpret_cast<uint32_t *>(block) = static_cast<uint32_t>(sizeClass);
+    m_residentBytes.fetch_add(kSizeClasses[sizeClass], std::memory_order_relaxed);
+    return block + kHeaderSize;
+}
+
+// 把缓冲区释放回堆
+void CUVBufferPool::deallocate(char *data, size_t sizeClass)
+{
+    m_residentBytes.fetch_sub(kSizeClasses[sizeClass], std::memory_order_relaxed);
+    ::operator delete(data - kHeaderSize);
+}
+
+// 在循环线程中把缓冲区放回空闲链表，超出缓存上限时释放回堆
+void CUVBufferPool::recycle(char *data, size_t sizeClass)
+{
+    std::vector<char *> &freeList = m_freeLists[sizeClass];
+    if (freeList.size() >= m_maxCachedCount[sizeClass]) {
+        deallocate(data, sizeClass);
+        return;
+    }
+
+    freeList.push_back(data);
+    m_cachedBytes.fetch_add(kSizeClasses[sizeClass], std::memory_order_relaxed);
+}
+
+// 回收其他线程归还的缓冲区
+void CUVBufferPool::collectReturned()
+{
+    char *returned[kCollectBatchSize];
+    size_t count = m_returned.try_dequeue_bulk(returned, kCollectBatchSize);
+    for (size_t i = 0; i < count; ++i) {
+        size_t sizeClass = sizeClassOf(returned[i]);
+        m_cachedBytes.fetch_sub(kSizeClasses[sizeClass], std::memory_order_relaxed);
+        recycle(returned[i], sizeClass);
+    }
+}
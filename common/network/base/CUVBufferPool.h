@@ -0,0 +1,183 @@
+#ifndef CUVBUFFERPOOL_H
+#define CUVBUFFERPOOL_H
+
+#include "concurrentqueue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 事件循环的读缓冲池，按尺寸等级缓存空闲缓冲区，替代每次读取时的new/delete
+ * @details 每个事件循环一个，由循环共享持有；缓冲区前有一个小头部记录尺寸等级，
+ *          归还时不需要传入大小；每个等级一个空闲链表（后进先出，缓存更热），
+ *          链表中缓存的字节数超出上限时多余的缓冲区直接释放回堆；
+ *          acquire()只能在所属事件循环线程中调用，release()可在任意线程中调用，
+ *          其他线程归还的缓冲区先进入无锁归还队列，由循环线程在下次取用时回收
+ */
+class CUVBufferPool : public std::enable_shared_from_this<CUVBufferPool>
+{
+public:
+    // 尺寸等级，单位字节；最大等级与libuv建议的读缓冲区大小一致
+    static constexpr size_t kSizeClassCount = 4;
+    static constexpr size_t kSizeClasses[kSizeClassCount] = {1024, 4096, 16384, 65536};
+
+    static constexpr size_t kDefaultMaxCachedBytes = 1024 * 1024; // 默认每个等级最多缓存的字节数
+
+    /**
+     * @brief 缓冲池统计信息
+     */
+    struct Stats
+    {
+        uint64_t acquires;       // 取用次数
+        uint64_t hits;           // 从空闲链表取到缓冲区的次数
+        double hitRate;          // 命中率，0~1
+        uint64_t remoteReleases; // 在其他线程中归还的次数
+        size_t residentBytes;    // 驻留字节数（已从堆分配且尚未释放的缓冲区）
+        size_t cachedBytes;      // 空闲链表和归还队列中缓存的字节数
+        size_t inUseBytes;       // 使用中的字节数
+    };
+
+    /**
+     * @brief 读取大小估计器，每个连接一个，根据最近的读取大小选择下一次的缓冲区尺寸
+     * @details 读满缓冲区时升一级；连续若干次读取都能放进低一级的缓冲区时降一级，
+     *          空闲或只收发小报文的连接因此只占用小缓冲区；只能在事件循环线程中使用
+     */
+    class ReadSizeEstimator
+    {
+    public:
+        static constexpr uint8_t kInitialClass = 1; // 初始尺寸等级
+        static constexpr uint8_t kShrinkAfter = 8;  // 连续多少次小读取后降级
+
+        /**
+         * @brief 下一次读取应使用的缓冲区尺寸
+         */
+        size_t next() const { return kSizeClasses[m_sizeClass]; }
+
+        /**
+         * @brief 记录一次读取
+         * @param nread 读取的字节数
+         * @param capacity 本次读取所用缓冲区的容量
+         */
+        void record(size_t nread, size_t capacity);
+
+    private:
+        uint8_t m_sizeClass = kInitialClass; // 当前尺寸等级
+        uint8_t m_smallReads = 0;            // 连续小读取的次数
+    };
+
+    /**
+     * @brief 池化缓冲区的独占所有权，析构时归还到缓冲池，可在任意线程中持有和销毁
+     * @details 持有缓冲池的共享引用，事件循环销毁后仍可安全归还
+     */
+    class Buffer
+    {
+        friend class CUVBufferPool;
+
+    public:
+        Buffer() = default;
+        ~Buffer() { reset(); }
+
+        Buffer(Buffer &&other) noexcept;
+        Buffer &operator=(Buffer &&other) noexcept;
+
+        // 禁止拷贝
+        Buffer(const Buffer &) = delete;
+        Buffer &operator=(const Buffer &) = delete;
+
+        char *data() const { return m_data; }
+        size_t size() const { return m_size; } // 有效数据长度
+        size_t capacity() const;               // 缓冲区容量
+        bool empty() const { return m_data == nullptr; }
+
+        /**
+         * @brief 立即归还缓冲区
+         */
+        void reset();
+
+    private:
+        Buffer(std::shared_ptr<CUVBufferPool> pool, char *data, size_t size);
+
+        std::shared_ptr<CUVBufferPool> m_pool; // 所属缓冲池
+        char *m_data = nullptr;                // 缓冲区
+        size_t m_size = 0;                     // 有效数据长度
+    };
+
+    /**
+     * @brief 构造函数
+     * @param maxCachedBytes 每个尺寸等级最多缓存的字节数
+     */
+    explicit CUVBufferPool(size_t maxCachedBytes = kDefaultMaxCachedBytes);
+    ~CUVBufferPool();
+
+    // 禁止拷贝构造和赋值操作
+    CUVBufferPool(const CUVBufferPool &) = delete;
+    CUVBufferPool &operator=(const CUVBufferPool &) = delete;
+
+    /**
+     * @brief 设置所属事件循环线程，由事件循环在工作线程启动时调用
+     */
+    void setOwnerThread(std::thread::id threadId);
+
+    /**
+     * @brief 取用一个缓冲区，只能在所属事件循环线程中调用
+     * @param size 需要的大小，向上取整到尺寸等级，超出最大等级时按最大等级分配
+     * @param capacity 返回缓冲区的实际容量
+     * @return 缓冲区
+     */
+    char *acquire(size_t size, size_t *capacity);
+
+    /**
+     * @brief 归还由acquire()取用的缓冲区，可在任意线程中调用
+     * @param data 缓冲区，nullptr时无操作
+     */
+    void release(char *data);
+
+    /**
+     * @brief 将acquire()取用的缓冲区包装为独占所有权，缓冲池必须由std::shared_ptr持有
+     * @param data 缓冲区
+     * @param size 有效数据长度
+     */
+    Buffer adopt(char *data, size_t size);
+
+    /**
+     * @brief 获取缓冲区的容量
+     */
+    static size_t capacityOf(const char *data);
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+private:
+    static size_t sizeClassOf(size_t size);
+    static size_t sizeClassOf(const char *data);
+
+    char *allocate(size_t sizeClass);
+    void deallocate(char *data, size_t sizeClass);
+    void recycle(char *data, size_t sizeClass);
+    void collectReturned();
+
+private:
+    std::thread::id m_ownerThread;                    // 所属事件循环线程
+    size_t m_maxCachedCount[kSizeClassCount];         // 每个等级最多缓存的缓冲区数
+    std::vector<char *> m_freeLists[kSizeClassCount]; // 空闲链表，仅循环线程访问
+    moodycamel::ConcurrentQueue<char *> m_returned;   // 其他线程归还的缓冲区
+
+    std::atomic<uint64_t> m_acquireCount;       // 取用次数
+    std::atomic<uint64_t> m_hitCount;           // 命中次数
+    std::atomic<uint64_t> m_remoteReleaseCount; // 其他线程归还的次数
+    std::atomic<size_t> m_residentBytes;        // 驻留字节数
+    std::atomic<size_t> m_cachedBytes;          // 缓存字节数
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVBUFFERPOOL_H
@@ -0,0 +1,95 @@
+#include "CUVChannel.h"
+
+using namespace Common::Network;
+
+// 构造函数
+CUVChannelBase::CUVChannelBase(CUVLoop *loop, size_t batchBudget)
+    : m_loop(loop)
+    , m_async(nullptr)
+    , m_batchBudget(batchBudget)
+    , m_wakePending(false)
+    , m_wakeupCount(0)
+    , m_rejectedCount(0)
+    , m_receivedCount(0)
+    , m_drainCount(0)
+{}
+
+// 析构函数
+CUVChannelBase::~CUVChannelBase() {}
+
+// 获取统计信息
+CUVChannelBase::Stats CUVChannelBase::getStats() const
+{
+    return Stats{m_receivedCount.load(std::memory_order_relaxed),
+                 m_wakeupCount.load(std::memory_order_relaxed),
+                 m_drainCount.load(std::memory_order_relaxed),
+                 m_rejectedCount.load(std::memory_order_relaxed)};
+}
+
+// 在接收端事件循环中初始化异步句柄
+void CUVChannelBase::open()
+{
+    if (!m_loop || isOpen()) {
+        return;
+    }
+
+    auto init = [this]() {
+        uv_async_t *async = new uv_async_t;
+        if (uv_async_init(m_loop->getLoop(), async, onAsync) != 0) {
+            delete async;
+            return;
+        }
+        async->data = this;
+        // 通道不阻止事件循环退出
+        uv_unref(reinterpret_cast<uv_handle_t *>(async));
+        m_async.store(async, std::memory_order_release);
+    };
+
+    if (m_loop->isInLoopThread()) {
+        init();
+    } else {
+        m_loop->submit(init, CUVLoop::TaskPriority::HIGH).wait();
+    }
+}
+
+// 在接收端事件循环中关闭异步句柄
+void CUVChannelBase::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    // 句柄在循环线程中置空，排空回调中的重新唤醒不会用到已关闭的句柄
+    auto destroy = [this]() {
+        uv_async_t *async = m_async.exchange(nullptr, std::memory_order_acq_rel);
+        if (async) {
+            uv_close(reinterpret_cast<uv_handle_t *>(async),
+                     [](uv_handle_t *handle) { delete reinterpret_cast<uv_async_t *>(handle); });
+        }
+    };
+
+    // 关闭后不会再触发回调；事件循环已停止时任务被拒绝，句柄随之泄漏
+    if (m_loop->isInLoopThread()) {
+        destroy();
+    } else if (!m_loop->submit(destroy, CUVLoop::TaskPriority::HIGH).wait()) {
+        m_async.store(nullptr, std::memory_order_release);
+    }
+}
+
+// 异步唤醒回调
+void CUVChannelBase::onAsync(uv_async_t *handle)
+{
+    CUVChannelBase *channel = static_cast<CUVChannelBase *>(handle->data);
+
+    // 先清除唤醒标志再排空，保证排空期间到达的消息会触发新的唤醒
+    channel->m_wakePending.exchange(false, std::memory_order_acq_rel);
+    channel->m_drainCount.fetch_add(1, std::memory_order_relaxed);
+
+    size_t count = channel->drain(channel->m_batchBudget);
+    channel->m_receivedCount.fetch_add(count, std::memory_order_relaxed);
+
+    // 超出预算时让出循环处理I/O，并重新唤醒自己继续排空；通道已关闭时不再唤醒
+    if (channel->m_batchBudget > 0 && count >= channel->m_batchBudget && channel->isOpen()) {
+        channel->wakeup();
+    }
+}
@@ -0,0 +1,403 @@
+#ifndef CUVCHANNEL_H
+#define CUVCHANNEL_H
+
+#include "CUVLoop.h"
+#include "concurrentqueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <uv.h>
+#include <vector>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 跨事件循环通道的公共部分：接收端事件循环上的uv_async_t与唤醒合并
+ * @details 每个通道一个uv_async_t，只有排空之后的第一条消息发出唤醒，其余消息在同一次排空中处理；
+ *          通道必须在接收端事件循环销毁之前销毁，且不能在接收回调中销毁；
+ *          异步句柄不阻止事件循环退出
+ */
+class CUVChannelBase
+{
+public:
+    static constexpr size_t kDefaultBatchBudget = 1024; // 默认每次唤醒最多处理的消息数
+
+    /**
+     * @brief 通道统计信息
+     */
+    struct Stats
+    {
+        uint64_t received; // 已处理的消息数
+        uint64_t wakeups;  // 实际发出的唤醒次数（uv_async_send调用次数）
+        uint64_t drains;   // 排空次数
+        uint64_t rejected; // 因通道已满或未打开被拒绝的消息数
+    };
+
+    // 禁止拷贝构造和赋值操作
+    CUVChannelBase(const CUVChannelBase &) = delete;
+    CUVChannelBase &operator=(const CUVChannelBase &) = delete;
+
+    /**
+     * @brief 通道是否已在接收端事件循环上打开
+     */
+    bool isOpen() const { return m_async.load(std::memory_order_acquire) != nullptr; }
+
+    /**
+     * @brief 获取接收端事件循环
+     */
+    CUVLoop *getLoop() const { return m_loop; }
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+protected:
+    /**
+     * @brief 构造函数
+     * @param loop 接收端事件循环
+     * @param batchBudget 每次唤醒最多处理的消息数，0表示不限制
+     */
+    CUVChannelBase(CUVLoop *loop, size_t batchBudget);
+    virtual ~CUVChannelBase();
+
+    /**
+     * @brief 在接收端事件循环中初始化异步句柄，由派生类在队列就绪后调用
+     * @details 在其他线程中调用时等待初始化完成
+     */
+    void open();
+
+    /**
+     * @brief 在接收端事件循环中关闭异步句柄，由派生类在析构时调用
+     * @details 在其他线程中调用时等待关闭完成，之后不会再调用drain()
+     */
+    void close();
+
+    /**
+     * @brief 唤醒接收端，已有未处理的唤醒时不重复发送，通道已关闭时不做任何处理
+     */
+    void wakeup()
+    {
+        if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+            if (uv_async_t *async = m_async.load(std::memory_order_acquire)) {
+                m_wakeupCount.fetch_add(1, std::memory_order_relaxed);
+                uv_async_send(async);
+            }
+        }
+    }
+
+    /**
+     * @brief 记录一条被拒绝的消息
+     */
+    void reject() { m_rejectedCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief 在接收端事件循环中处理已到达的消息
+     * @param budget 最多处理的消息数，0表示不限制
+     * @return 处理的消息数
+     */
+    virtual size_t drain(size_t budget) = 0;
+
+private:
+    static void onAsync(uv_async_t *handle);
+
+private:
+    CUVLoop *m_loop;                       // 接收端事件循环
+    std::atomic<uv_async_t *> m_async;     // 异步唤醒句柄，未打开或已关闭时为nullptr
+    size_t m_batchBudget;                  // 每次唤醒最多处理的消息数
+    std::atomic<bool> m_wakePending;       // 是否已有未处理的唤醒
+    std::atomic<uint64_t> m_wakeupCount;   // 唤醒次数
+    std::atomic<uint64_t> m_rejectedCount; // 被拒绝的消息数
+    std::atomic<uint64_t> m_receivedCount; // 已处理的消息数，仅接收端写入
+    std::atomic<uint64_t> m_drainCount;    // 排空次数，仅接收端写入
+};
+
+/**
+ * @brief 单生产者单接收者通道
+ * @details 容量固定的环形缓冲区，消息直接构造在预分配的槽位中，发送和接收都不分配内存；
+ *          同一时刻只能有一个线程发送，接收回调在接收端事件循环线程中执行
+ */
+template<typename T>
+class CUVSpscChannel : public CUVChannelBase
+{
+public:
+    using Handler = std::function<void(T &)>; // 接收回调，可以从参数中移走数据
+
+    /**
+     * @brief 构造函数
+     * @param loop 接收端事件循环
+     * @param capacity 容量，向上取整为2的幂
+     * @param handler 接收回调
+     * @param batchBudget 每次唤醒最多处理的消息数，0表示不限制
+     */
+    CUVSpscChannel(CUVLoop *loop,
+                   size_t capacity,
+                   Handler handler,
+                   size_t batchBudget = kDefaultBatchBudget)
+        : CUVChannelBase(loop, batchBudget)
+        , m_handler(std::move(handler))
+        , m_head(0)
+        , m_cachedTail(0)
+        , m_tail(0)
+        , m_cachedHead(0)
+    {
+        m_capacity = 1;
+        while (m_capacity < capacity) {
+            m_capacity <<= 1;
+        }
+        m_mask = m_capacity - 1;
+        m_slots = static_cast<T *>(
+            ::operator new(sizeof(T) * m_capacity, std::align_val_t(alignof(T))));
+        open();
+    }
+
+    ~CUVSpscChannel() override
+    {
+        close();
+
+        // 丢弃尚未处理的消息
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        for (size_t head = m_head.load(std::memory_order_relaxed); head != tail; ++head) {
+            m_slots[head & m_mask].~T();
+        }
+        ::operator delete(m_slots, std::align_val_t(alignof(T)));
+    }
+
+    /**
+     * @brief 在槽位中直接构造一条消息并发送
+     * @return 是否发送成功，通道已满或未打开时返回false
+     */
+    template<typename... Args>
+    bool emplace(Args &&...args)
+    {
+        if (!isOpen()) {
+            reject();
+            return false;
+        }
+
+        // 先用缓存的读位置判断是否已满，确实已满时才读取接收端的位置
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity) {
+                reject();
+                return false;
+            }
+        }
+
+        new (&m_slots[tail & m_mask]) T(std::forward<Args>(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        wakeup();
+        return true;
+    }
+
+    bool send(const T &value) { return emplace(value); }
+    bool send(T &&value) { return emplace(std::move(value)); }
+
+    /**
+     * @brief 获取容量
+     */
+    size_t capacity() const { return m_capacity; }
+
+protected:
+    size_t drain(size_t budget) override
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (budget == 0 || count < budget) {
+            if (head == m_cachedTail) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail) {
+                    break;
+                }
+            }
+
+            // 每处理一条就归还槽位，发送端可以尽早复用
+            T &item = m_slots[head & m_mask];
+            m_handler(item);
+            item.~T();
+            m_head.store(++head, std::memory_order_release);
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    Handler m_handler; // 接收回调
+    T *m_slots;        // 槽位数组
+    size_t m_capacity; // 容量
+    size_t m_mask;     // 下标掩码
+
+    // 读写位置分处不同的缓存行，各自缓存对方的位置，减少跨核读取
+    alignas(kCacheLineSize) std::atomic<size_t> m_head; // 读位置，仅接收端写入
+    size_t m_cachedTail;                                // 接收端缓存的写位置
+    alignas(kCacheLineSize) std::atomic<size_t> m_tail; // 写位置，仅发送端写入
+    size_t m_cachedHead;                                // 发送端缓存的读位置
+};
+
+/**
+ * @brief 多生产者单接收者通道
+ * @details 基于moodycamel::ConcurrentQueue，任意线程都可以发送，长期存在的发送线程可以用
+ *          createSender()取得带生产者令牌的发送句柄；指定容量时预分配队列并只用try_enqueue入队，
+ *          稳定运行后不再分配内存，容量为近似值；消息类型需要可默认构造和移动赋值
+ */
+template<typename T>
+class CUVMpscChannel : public CUVChannelBase
+{
+public:
+    using Handler = std::function<void(T &)>; // 接收回调，可以从参数中移走数据
+
+    /**
+     * @brief 长期存在的发送句柄
+     * @details 同一个句柄发送的消息按FIFO顺序处理；句柄只能由一个线程使用，且必须在通道销毁之前销毁
+     */
+    class Sender
+    {
+        friend class CUVMpscChannel;
+
+    public:
+        // 禁止拷贝构造和赋值操作
+        Sender(const Sender &) = delete;
+        Sender &operator=(const Sender &) = delete;
+
+        bool send(const T &value) { return m_channel->enqueue(&m_token, value); }
+        bool send(T &&value) { return m_channel->enqueue(&m_token, std::move(value)); }
+
+        /**
+         * @brief 批量发送，只触发一次唤醒
+         * @param values 消息数组，发送成功时被移走
+         * @param count 消息数量
+         * @return 是否全部发送成功
+         */
+        bool sendBulk(T *values, size_t count)
+        {
+            return m_channel->enqueueBulk(m_token, values, count);
+        }
+
+    private:
+        explicit Sender(CUVMpscChannel *channel)
+            : m_channel(channel)
+            , m_token(channel->m_queue)
+        {}
+
+        CUVMpscChannel *m_channel;         // 所属通道
+        moodycamel::ProducerToken m_token; // 生产者令牌
+    };
+
+    /**
+     * @brief 构造函数
+     * @param loop 接收端事件循环
+     * @param handler 接收回调
+     * @param capacity 预分配的容量，0表示不限制
+     * @param batchBudget 每次唤醒最多处理的消息数，0表示不限制
+     */
+    CUVMpscChannel(CUVLoop *loop,
+                   Handler handler,
+                   size_t capacity = 0,
+                   size_t batchBudget = kDefaultBatchBudget)
+        : CUVChannelBase(loop, batchBudget)
+        , m_handler(std::move(handler))
+        , m_bounded(capacity > 0)
+        , m_queue(capacity > 0 ? capacity : kInitialCapacity)
+        , m_consumerToken(m_queue)
+        , m_batch(kBatchSize)
+    {
+        open();
+    }
+
+    ~CUVMpscChannel() override { close(); }
+
+    bool send(const T &value) { return enqueue(nullptr, value); }
+    bool send(T &&value) { return enqueue(nullptr, std::move(value)); }
+
+    /**
+     * @brief 为长期存在的发送线程创建发送句柄
+     */
+    std::unique_ptr<Sender> createSender() { return std::unique_ptr<Sender>(new Sender(this)); }
+
+protected:
+    size_t drain(size_t budget) override
+    {
+        size_t count = 0;
+        while (budget == 0 || count < budget) {
+            size_t maxCount = budget == 0 ? kBatchSize : (std::min)(kBatchSize, budget - count);
+            size_t dequeued = m_queue.try_dequeue_bulk(m_consumerToken, m_batch.begin(), maxCount);
+            if (dequeued == 0) {
+                break;
+            }
+            for (size_t i = 0; i < dequeued; ++i) {
+                m_handler(m_batch[i]);
+                m_batch[i] = T();
+            }
+            count += dequeued;
+        }
+        return count;
+    }
+
+private:
+    static constexpr size_t kBatchSize = 64;        // 每次批量出队的消息数
+    static constexpr size_t kInitialCapacity = 1024; // 不限制容量时预分配的容量
+
+    template<typename U>
+    bool enqueue(moodycamel::ProducerToken *token, U &&value)
+    {
+        if (!isOpen()) {
+            reject();
+            return false;
+        }
+
+        bool accepted;
+        if (m_bounded) {
+            accepted = token ? m_queue.try_enqueue(*token, std::forward<U>(value))
+                             : m_queue.try_enqueue(std::forward<U>(value));
+        } else {
+            accepted = token ? m_queue.enqueue(*token, std::forward<U>(value))
+                             : m_queue.enqueue(std::forward<U>(value));
+        }
+        if (!accepted) {
+            reject();
+            return false;
+        }
+        wakeup();
+        return true;
+    }
+
+    bool enqueueBulk(moodycamel::ProducerToken &token, T *values, size_t count)
+    {
+        if (!isOpen()) {
+            reject();
+            return false;
+        }
+
+        auto first = std::make_move_iterator(values);
+        bool accepted = m_bounded ? m_queue.try_enqueue_bulk(token, first, count)
+                                  : m_queue.enqueue_bulk(token, first, count);
+        if (!accepted) {
+            reject();
+            return false;
+        }
+        wakeup();
+        return true;
+    }
+
+private:
+    Handler m_handler;                         // 接收回调
+    bool m_bounded;                            // 是否限制容量
+    moodycamel::ConcurrentQueue<T> m_queue;    // 消息队列
+    moodycamel::ConsumerToken m_consumerToken; // 接收端的消费者令牌
+    std::vector<T> m_batch;                    // 出队缓冲区，仅接收端访问
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVCHANNEL_H
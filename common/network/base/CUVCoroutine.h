@@ -0,0 +1,506 @@
+#ifndef CUVCOROUTINE_H
+#define CUVCOROUTINE_H
+
+/**
+ * 可选的C++20协程层，与回调接口并存
+ * 只有以C++20编译（编译器支持协程）时才可用，此时定义CUV_HAS_COROUTINES为1；
+ * 工程默认以C++17编译，此时本文件为空
+ */
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CUV_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef CUV_HAS_COROUTINES
+
+#include "CUVLoop.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 协程帧内存池
+ * @details 按大小分级的空闲链表，每个线程一份；协程由spawn()在事件循环线程中启动并在该线程中恢复，
+ *          因此实际上每个事件循环一个池，分配和释放都不需要加锁；
+ *          每个级别最多缓存kMaxCached块，超出或超过最大级别的帧直接使用全局堆
+ */
+class CUVFramePool
+{
+public:
+    static void *allocate(size_t size)
+    {
+        size_t index = sizeClass(size);
+        if (index < kClassCount) {
+            Cache &cache = local();
+            if (FreeNode *node = cache.heads[index]) {
+                cache.heads[index] = node->next;
+                --cache.counts[index];
+                return node;
+            }
+            return ::operator new(kMinSize << index);
+        }
+        return ::operator new(size);
+    }
+
+    static void deallocate(void *pointer, size_t size)
+    {
+        size_t index = sizeClass(size);
+        if (index < kClassCount) {
+            Cache &cache = local();
+            if (cache.counts[index] < kMaxCached) {
+                FreeNode *node = static_cast<FreeNode *>(pointer);
+                node->next = cache.heads[index];
+                cache.heads[index] = node;
+                ++cache.counts[index];
+                return;
+            }
+        }
+        ::operator delete(pointer);
+    }
+
+private:
+    static constexpr size_t kMinSize = 64;    // 最小级别的块大小
+    static constexpr size_t kClassCount = 7;  // 级别数，64字节到4KB
+    static constexpr size_t kMaxCached = 256; // 每个级别最多缓存的块数
+
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    struct Cache
+    {
+        FreeNode *heads[kClassCount] = {};
+        size_t counts[kClassCount] = {};
+
+        ~Cache()
+        {
+            for (FreeNode *node : heads) {
+                while (node) {
+                    FreeNode *next = node->next;
+                    ::operator delete(node);
+                    node = next;
+                }
+            }
+        }
+    };
+
+    static size_t sizeClass(size_t size)
+    {
+        size_t index = 0;
+        while (index < kClassCount && (kMinSize << index) < size) {
+            ++index;
+        }
+        return index;
+    }
+
+    static Cache &local()
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+};
+
+template<typename T = void>
+class CUVCoTask;
+
+/**
+ * @brief 协程promise中与结果类型无关的部分
+ */
+class CUVCoPromiseBase
+{
+public:
+    static void *operator new(size_t size) { return CUVFramePool::allocate(size); }
+    static void operator delete(void *pointer, size_t size)
+    {
+        CUVFramePool::deallocate(pointer, size);
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // 结束时直接切换到等待者，被spawn()分离的协程自行销毁
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            CUVCoPromiseBase &promise = handle.promise();
+            if (promise.m_detached) {
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            if (promise.m_continuation) {
+                return promise.m_continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // 网络层不使用异常，协程中抛出的异常视为致命错误
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    void setContinuation(std::coroutine_handle<> continuation) { m_continuation = continuation; }
+    void setDetached() { m_detached = true; }
+
+    // 被另一个协程等待时沿用它的顶层协程
+    void setParent(const CUVCoPromiseBase &parent) { m_root = parent.m_root; }
+
+    /**
+     * @brief 销毁本协程所在的整条等待链
+     * @details 从顶层协程开始销毁，顶层协程帧中的CUVCoTask依次销毁被等待的协程；
+     *          只有顶层协程已被spawn()分离时才销毁，否则它归调用者所有，返回false
+     */
+    bool destroyChain()
+    {
+        if (!m_root->m_detached) {
+            return false;
+        }
+        m_root->m_self.destroy();
+        return true;
+    }
+
+protected:
+    void setSelf(std::coroutine_handle<> self) { m_self = self; }
+
+private:
+    std::coroutine_handle<> m_continuation; // 等待本协程的协程
+    std::coroutine_handle<> m_self;         // 本协程
+    CUVCoPromiseBase *m_root = this;        // 等待链的顶层协程
+    bool m_detached = false;                // 是否已分离
+};
+
+/**
+ * @brief 协程返回类型
+ * @details 惰性启动：被co_await时才开始执行，结束时直接恢复等待者（对称转移），
+ *          不经过任务队列；顶层协程用spawn()在事件循环中启动
+ */
+template<typename T>
+class CUVCoTask
+{
+public:
+    struct promise_type : CUVCoPromiseBase
+    {
+        CUVCoTask get_return_object()
+        {
+            auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+            setSelf(handle);
+            return CUVCoTask(handle);
+        }
+
+        template<typename Value>
+        void return_value(Value &&value)
+        {
+            m_value.emplace(std::forward<Value>(value));
+        }
+
+        std::optional<T> m_value; // 协程返回值
+    };
+
+    CUVCoTask(CUVCoTask &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {}
+
+    CUVCoTask &operator=(CUVCoTask &&other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~CUVCoTask()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // 禁止拷贝
+    CUVCoTask(const CUVCoTask &) = delete;
+    CUVCoTask &operator=(const CUVCoTask &) = delete;
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+    {
+        m_handle.promise().setContinuation(awaiting);
+        if constexpr (std::is_base_of_v<CUVCoPromiseBase, Promise>) {
+            m_handle.promise().setParent(awaiting.promise());
+        }
+        return m_handle;
+    }
+
+    T await_resume() { return std::move(*m_handle.promise().m_value); }
+
+private:
+    template<typename U>
+    friend void spawn(CUVLoop *loop, CUVCoTask<U> &&task);
+
+    explicit CUVCoTask(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {}
+
+    std::coroutine_handle<promise_type> release() { return std::exchange(m_handle, nullptr); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle; // 协程句柄
+};
+
+template<>
+class CUVCoTask<void>
+{
+public:
+    struct promise_type : CUVCoPromiseBase
+    {
+        CUVCoTask get_return_object()
+        {
+            auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+            setSelf(handle);
+            return CUVCoTask(handle);
+        }
+
+        void return_void() {}
+    };
+
+    CUVCoTask(CUVCoTask &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {}
+
+    CUVCoTask &operator=(CUVCoTask &&other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~CUVCoTask()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // 禁止拷贝
+    CUVCoTask(const CUVCoTask &) = delete;
+    CUVCoTask &operator=(const CUVCoTask &) = delete;
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept
+    {
+        m_handle.promise().setContinuation(awaiting);
+        if constexpr (std::is_base_of_v<CUVCoPromiseBase, Promise>) {
+            m_handle.promise().setParent(awaiting.promise());
+        }
+        return m_handle;
+    }
+
+    void await_resume() noexcept {}
+
+private:
+    template<typename U>
+    friend void spawn(CUVLoop *loop, CUVCoTask<U> &&task);
+
+    explicit CUVCoTask(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {}
+
+    std::coroutine_handle<promise_type> release() { return std::exchange(m_handle, nullptr); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle; // 协程句柄
+};
+
+/**
+ * @brief 在事件循环中启动一个顶层协程，协程结束后自行销毁
+ * @details 在循环线程中调用时立即开始执行，否则投递一次任务；
+ *          任务被拒绝或被丢弃（DROP_OLDEST策略、事件循环停止）时协程尚未开始执行，
+ *          随任务一起销毁
+ * @param loop 事件循环
+ * @param task 协程
+ */
+template<typename T>
+void spawn(CUVLoop *loop, CUVCoTask<T> &&task)
+{
+    if (loop->isInLoopThread()) {
+        auto handle = task.release();
+        handle.promise().setDetached();
+        handle.resume();
+        return;
+    }
+
+    loop->postTask([task = std::move(task)]() mutable {
+        auto handle = task.release();
+        handle.promise().setDetached();
+        handle.resume();
+    });
+}
+
+/**
+ * @brief 切换到指定事件循环线程继续执行
+ * @details 已在该循环线程中时不挂起；await结果表示是否切换成功，
+ *          任务被拒绝（事件循环已停止）时在原线程中继续执行并返回false；
+ *          任务已被接受、但随事件循环停止而丢弃时协程不会再恢复，
+ *          此时在丢弃任务的线程中销毁spawn()启动的整条等待链，
+ *          未被分离的协程归调用者所有，不会被销毁
+ */
+class CUVSwitchAwaiter
+{
+public:
+    explicit CUVSwitchAwaiter(CUVLoop *loop)
+        : m_loop(loop)
+        , m_switched(true)
+    {}
+
+    bool await_ready() const { return m_loop->isInLoopThread(); }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        CUVCoPromiseBase *promise = nullptr;
+        if constexpr (std::is_base_of_v<CUVCoPromiseBase, Promise>) {
+            promise = &handle.promise();
+        }
+
+        // 投递成功后协程可能已在目标线程中恢复，不能再访问本对象，因此先假定切换成功
+        m_switched = true;
+        CUVTask task([resume = Resume(handle, promise, &m_switched)]() mutable { resume(); });
+        if (m_loop->postTask(std::move(task), CUVLoop::TaskPriority::HIGH)) {
+            return true;
+        }
+
+        // 被拒绝的任务仍持有凭据，在本函数返回前销毁，此时不能销毁协程
+        m_switched = false;
+        return false;
+    }
+
+    bool await_resume() const { return m_switched; }
+
+private:
+    // 恢复凭据，随任务一起移动；任务未执行就被销毁时销毁协程所在的等待链
+    class Resume
+    {
+    public:
+        Resume(std::coroutine_handle<> handle, CUVCoPromiseBase *promise, const bool *accepted)
+            : m_handle(handle)
+            , m_promise(promise)
+            , m_accepted(accepted)
+        {}
+
+        Resume(Resume &&other) noexcept
+            : m_handle(std::exchange(other.m_handle, nullptr))
+            , m_promise(other.m_promise)
+            , m_accepted(other.m_accepted)
+        {}
+
+        ~Resume()
+        {
+            if (m_handle && m_promise && *m_accepted) {
+                m_promise->destroyChain();
+            }
+        }
+
+        // 禁止拷贝
+        Resume(const Resume &) = delete;
+        Resume &operator=(const Resume &) = delete;
+
+        void operator()() { std::exchange(m_handle, nullptr).resume(); }
+
+    private:
+        std::coroutine_handle<> m_handle; // 挂起的协程
+        CUVCoPromiseBase *m_promise;      // 协程的promise，不是本层协程时为nullptr
+        const bool *m_accepted;           // 任务是否已被接受（位于协程帧中）
+    };
+
+private:
+    CUVLoop *m_loop; // 目标事件循环
+    bool m_switched; // 是否切换成功
+};
+
+inline CUVSwitchAwaiter switchTo(CUVLoop *loop)
+{
+    return CUVSwitchAwaiter(loop);
+}
+
+/**
+ * @brief 协程睡眠
+ * @details 定时器节点内嵌在等待者中（即协程帧中），挂在事件循环的时间轮上，
+ *          到期时在时间轮回调中直接恢复协程；只能在事件循环线程中使用，
+ *          事件循环停止后未到期的睡眠不会再恢复
+ */
+class CUVSleepAwaiter
+{
+public:
+    CUVSleepAwaiter(CUVLoop *loop, uint64_t delayMs)
+        : m_loop(loop)
+        , m_delay(delayMs)
+    {}
+
+    bool await_ready() const { return m_delay == 0; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_handle = handle;
+        m_timer.callback = onExpired;
+        m_timer.data = this;
+        m_loop->getTimingWheel()->schedule(&m_timer, m_delay);
+    }
+
+    void await_resume() const {}
+
+    // 协程在睡眠中被销毁时把节点从时间轮中摘除
+    ~CUVSleepAwaiter()
+    {
+        if (CUVTimingWheel::isScheduled(&m_timer)) {
+            m_loop->getTimingWheel()->cancel(&m_timer);
+        }
+    }
+
+private:
+    static void onExpired(CUVTimingWheel::Timer *timer)
+    {
+        static_cast<CUVSleepAwaiter *>(timer->data)->m_handle.resume();
+    }
+
+private:
+    CUVLoop *m_loop;                  // 所属事件循环
+    uint64_t m_delay;                 // 延迟，单位毫秒
+    CUVTimingWheel::Timer m_timer;    // 时间轮节点
+    std::coroutine_handle<> m_handle; // 挂起的协程
+};
+
+inline CUVSleepAwaiter sleepFor(CUVLoop *loop, uint64_t delayMs)
+{
+    return CUVSleepAwaiter(loop, delayMs);
+}
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUV_HAS_COROUTINES
+
+#endif // CUVCOROUTINE_H
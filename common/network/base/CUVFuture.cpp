@@ -0,0 +1,94 @@
+#include "CUVFuture.h"
+#include "CUVLoop.h"
+#include <chrono>
+
+using namespace Common::Network;
+
+// 构造函数，引用计数初始为1，归CUVPromise所有
+CUVFutureStateBase::CUVFutureStateBase()
+    : m_refCount(1)
+    , m_status(PENDING)
+    , m_hasWaiter(false)
+    , m_continuationLoop(nullptr)
+{}
+
+// 阻塞等待结果
+bool CUVFutureStateBase::wait()
+{
+    if (!isReady()) {
+        // 先登记等待者再检查状态，与complete()中先写状态再检查等待者配对，不会丢失唤醒
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_hasWaiter.store(true);
+        m_cond.wait(lock, [this] { return m_status.load() >= READY; });
+    }
+    return !isBroken();
+}
+
+// 限时阻塞等待结果
+bool CUVFutureStateBase::waitFor(uint64_t timeoutMs)
+{
+    if (!isReady()) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_hasWaiter.store(true);
+        if (!m_cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+                return m_status.load() >= READY;
+            })) {
+            return false;
+        }
+    }
+    return !isBroken();
+}
+
+// 设置后续任务
+void CUVFutureStateBase::setContinuation(CUVLoop *loop, CUVTask &&continuation)
+{
+    m_continuation = std::move(continuation);
+    m_continuationLoop = loop;
+
+    int expected = PENDING;
+    if (m_status.compare_exchange_strong(expected, CONTINUATION, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // 结果已经就绪，立即调度
+    if (expected == READY) {
+        dispatchContinuation();
+    } else {
+        m_continuation.reset();
+    }
+}
+
+// 标记完成
+void CUVFutureStateBase::complete(bool broken)
+{
+    int previous = m_status.exchange(broken ? BROKEN : READY);
+
+    if (m_hasWaiter.load()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cond.notify_all();
+    }
+
+    if (previous == CONTINUATION) {
+        if (broken) {
+            m_continuation.reset();
+        } else {
+            dispatchContinuation();
+        }
+    }
+}
+
+// 执行或投递后续任务
+void CUVFutureStateBase::dispatchContinuation()
+{
+    CUVTask continuation = std::move(m_continuation);
+    CUVLoop *loop = m_continuationLoop;
+
+    if (!loop || loop->isInLoopThread()) {
+        continuation();
+        return;
+    }
+
+    // 后续任务是结果通知，走高优先级队列，不受普通队列容量限制；
+    // 目标循环已停止时任务被丢弃，其中持有的结果句柄随之释放
+    loop->postTask(std::move(continuation), CUVLoop::TaskPriority::HIGH);
+}
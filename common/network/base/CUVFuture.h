@@ -0,0 +1,339 @@
+#ifndef CUVFUTURE_H
+#define CUVFUTURE_H
+
+#include "CUVTask.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace Common {
+namespace Network {
+
+class CUVLoop;
+
+/**
+ * @brief CUVFuture/CUVPromise共享状态中与结果类型无关的部分
+ * @details 引用计数、完成状态、等待者和后续任务都在这里；
+ *          等待使用的互斥量和条件变量只在确实有线程阻塞等待时才会被使用
+ */
+class CUVFutureStateBase
+{
+public:
+    CUVFutureStateBase();
+    virtual ~CUVFutureStateBase() = default;
+
+    // 禁止拷贝构造和赋值操作
+    CUVFutureStateBase(const CUVFutureStateBase &) = delete;
+    CUVFutureStateBase &operator=(const CUVFutureStateBase &) = delete;
+
+    void addRef() { m_refCount.fetch_add(1, std::memory_order_relaxed); }
+    void release()
+    {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    /**
+     * @brief 结果是否已经就绪（包括任务被丢弃的情况）
+     */
+    bool isReady() const { return m_status.load(std::memory_order_acquire) >= READY; }
+
+    /**
+     * @brief 任务是否在产生结果之前被丢弃
+     */
+    bool isBroken() const { return m_status.load(std::memory_order_acquire) == BROKEN; }
+
+    /**
+     * @brief 阻塞等待结果
+     * @return 是否得到了结果，任务被丢弃时返回false
+     */
+    bool wait();
+
+    /**
+     * @brief 限时阻塞等待结果
+     * @param timeoutMs 超时时间，单位毫秒
+     * @return 是否在超时前得到了结果
+     */
+    bool waitFor(uint64_t timeoutMs);
+
+    /**
+     * @brief 设置后续任务，结果就绪后在指定循环中执行，只能设置一次
+     * @param loop 执行后续任务的事件循环，nullptr表示在完成结果的线程中直接执行
+     * @param continuation 后续任务，任务被丢弃时不执行
+     */
+    void setContinuation(CUVLoop *loop, CUVTask &&continuation);
+
+protected:
+    /**
+     * @brief 标记完成并唤醒等待者、调度后续任务
+     * @param broken 是否因任务被丢弃而完成
+     */
+    void complete(bool broken);
+
+private:
+    enum Status : int {
+        PENDING,      // 等待结果
+        CONTINUATION, // 等待结果，已设置后续任务
+        READY,        // 结果就绪
+        BROKEN        // 任务被丢弃，没有结果
+    };
+
+    /**
+     * @brief 执行或投递后续任务
+     */
+    void dispatchContinuation();
+
+private:
+    std::atomic<uint32_t> m_refCount; // 引用计数
+    std::atomic<int> m_status;        // 完成状态
+    std::atomic<bool> m_hasWaiter;    // 是否有线程阻塞等待
+    std::mutex m_mutex;               // 阻塞等待用的互斥量
+    std::condition_variable m_cond;   // 阻塞等待用的条件变量
+    CUVTask m_continuation;           // 后续任务
+    CUVLoop *m_continuationLoop;      // 执行后续任务的事件循环
+};
+
+/**
+ * @brief 带结果值的共享状态，一次分配同时容纳结果、引用计数和等待者
+ */
+template<typename T>
+class CUVFutureState : public CUVFutureStateBase
+{
+public:
+    using Stored = std::conditional_t<std::is_void<T>::value, bool, T>;
+
+    template<typename... Args>
+    void setValue(Args &&...args)
+    {
+        if constexpr (std::is_void<T>::value) {
+            m_value.emplace(true);
+        } else {
+            m_value.emplace(std::forward<Args>(args)...);
+        }
+        complete(false);
+    }
+
+    void setBroken() { complete(true); }
+
+    Stored &value() { return *m_value; }
+
+private:
+    std::optional<Stored> m_value; // 结果值
+};
+
+template<typename T>
+class CUVPromise;
+
+/**
+ * @brief 事件循环任务的结果句柄
+ * @details 只能移动；get()/wait()会阻塞调用线程，不要在产生结果的事件循环线程中调用；
+ *          也可以用then()设置后续任务，在结果就绪后于指定循环中执行而不阻塞任何线程
+ */
+template<typename T>
+class CUVFuture
+{
+    friend class CUVPromise<T>;
+
+public:
+    CUVFuture()
+        : m_state(nullptr)
+    {}
+
+    CUVFuture(CUVFuture &&other) noexcept
+        : m_state(other.m_state)
+    {
+        other.m_state = nullptr;
+    }
+
+    CUVFuture &operator=(CUVFuture &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_state = other.m_state;
+            other.m_state = nullptr;
+        }
+        return *this;
+    }
+
+    ~CUVFuture() { reset(); }
+
+    // 禁止拷贝
+    CUVFuture(const CUVFuture &) = delete;
+    CUVFuture &operator=(const CUVFuture &) = delete;
+
+    /**
+     * @brief 是否关联了共享状态
+     */
+    bool valid() const { return m_state != nullptr; }
+
+    /**
+     * @brief 结果是否已经就绪
+     */
+    bool isReady() const { return m_state && m_state->isReady(); }
+
+    /**
+     * @brief 任务是否在产生结果之前被丢弃（队列已满或事件循环已停止）
+     */
+    bool isBroken() const { return !m_state || m_state->isBroken(); }
+
+    /**
+     * @brief 阻塞等待结果
+     * @return 是否得到了结果
+     */
+    bool wait() { return m_state && m_state->wait(); }
+
+    /**
+     * @brief 限时阻塞等待结果
+     * @param timeoutMs 超时时间，单位毫秒
+     * @return 是否在超时前得到了结果
+     */
+    bool waitFor(uint64_t timeoutMs) { return m_state && m_state->waitFor(timeoutMs); }
+
+    /**
+     * @brief 阻塞等待并取出结果
+     * @details 任务被丢弃时（队列已满或事件循环已停止）返回std::nullopt，调用者必须检查，
+     *          被丢弃的提交不会被当作成功；void结果时返回是否得到了结果，与wait()相同
+     * @return 结果值，任务被丢弃时为空
+     */
+    std::conditional_t<std::is_void<T>::value, bool, std::optional<T>> get()
+    {
+        bool ok = wait();
+        if constexpr (std::is_void<T>::value) {
+            return ok;
+        } else {
+            if (ok) {
+                return std::move(m_state->value());
+            }
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief 设置后续任务，消耗本句柄
+     * @param loop 执行后续任务的事件循环，nullptr表示在产生结果的线程中直接执行
+     * @param func 后续任务，参数为结果值（void结果时无参数），任务被丢弃时不执行
+     */
+    template<typename Func>
+    void then(CUVLoop *loop, Func &&func)
+    {
+        if (!m_state) {
+            return;
+        }
+        CUVFutureState<T> *state = m_state;
+        state->setContinuation(loop,
+                               CUVTask([future = std::move(*this),
+                                        func = std::forward<Func>(func)]() mutable {
+                                   if constexpr (std::is_void<T>::value) {
+                                       func();
+                                   } else {
+                                       func(std::move(future.m_state->value()));
+                                   }
+                               }));
+    }
+
+    /**
+     * @brief 设置后续任务，在产生结果的线程中直接执行
+     */
+    template<typename Func>
+    void then(Func &&func)
+    {
+        then(nullptr, std::forward<Func>(func));
+    }
+
+private:
+    explicit CUVFuture(CUVFutureState<T> *state)
+        : m_state(state)
+    {}
+
+    void reset()
+    {
+        if (m_state) {
+            m_state->release();
+            m_state = nullptr;
+        }
+    }
+
+private:
+    CUVFutureState<T> *m_state; // 共享状态
+};
+
+/**
+ * @brief 结果的生产端，只能移动
+ * @details 与std::promise不同，共享状态带侵入式引用计数，一次分配即可；
+ *          析构时仍未设置结果则把共享状态标记为被丢弃，等待者不会永远阻塞
+ */
+template<typename T>
+class CUVPromise
+{
+public:
+    CUVPromise()
+        : m_state(new CUVFutureState<T>)
+    {}
+
+    CUVPromise(CUVPromise &&other) noexcept
+        : m_state(other.m_state)
+    {
+        other.m_state = nullptr;
+    }
+
+    CUVPromise &operator=(CUVPromise &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_state = other.m_state;
+            other.m_state = nullptr;
+        }
+        return *this;
+    }
+
+    ~CUVPromise() { reset(); }
+
+    // 禁止拷贝
+    CUVPromise(const CUVPromise &) = delete;
+    CUVPromise &operator=(const CUVPromise &) = delete;
+
+    /**
+     * @brief 获取关联的结果句柄
+     */
+    CUVFuture<T> getFuture()
+    {
+        m_state->addRef();
+        return CUVFuture<T>(m_state);
+    }
+
+    /**
+     * @brief 设置结果，只能设置一次
+     */
+    template<typename... Args>
+    void setValue(Args &&...args)
+    {
+        if (m_state) {
+            m_state->setValue(std::forward<Args>(args)...);
+            m_state->release();
+            m_state = nullptr;
+        }
+    }
+
+private:
+    void reset()
+    {
+        if (m_state) {
+            m_state->setBroken();
+            m_state->release();
+            m_state = nullptr;
+        }
+    }
+
+private:
+    CUVFutureState<T> *m_state; // 共享状态，设置结果后置空
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVFUTURE_H
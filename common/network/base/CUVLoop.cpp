@@ -1,28 +1,101 @@
 #include "CUVLoop.h"
 #include "concurrentqueue.h"
+#include <algorithm>
+#include <cassert>
 #include <functional>
+#include <iterator>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 using namespace Common::Network;
 
 // Task类型定义
-using Task = std::function<void()>;
+using Task = CUVTask;
+
+// 定时任务节点，创建后不再释放，结束后回收到节点池中复用
+struct CUVLoop::TimerNode
+{
+    CUVTimingWheel::Timer timer; // 时间轮节点
+    CUVTask task;                // 任务对象
+    uint64_t delay;              // 首次延迟，单位毫秒
+    uint64_t interval;           // 周期，0表示一次性任务
+    bool running;                // 周期任务是否正在执行，仅循环线程访问
+    std::atomic<uint64_t> state; // 代数左移一位，最低位为取消标志
+    CUVLoop *loop;               // 所属事件循环
+};
 
-// 私有构造函数
+// 全局实例的配置
+static CUVLoop::Config s_defaultConfig;
+static std::mutex s_defaultConfigMutex;
+
+// 构造函数
 CUVLoop::CUVLoop()
-    : m_loop(nullptr)
+    : CUVLoop(Config())
+{}
+
+// 按配置构造
+CUVLoop::CUVLoop(const Config &config)
+    : m_config(config)
+    , m_loop(nullptr)
     , m_isStopping(false)
+    , m_isDraining(false)
+    , m_drainTimeoutMs(0)
+    , m_drainDeadline(0)
+    , m_drainStartTime(0)
+    , m_drainStartExecuted(0)
+    , m_shutdownReport{false, 0, 0, 0, 0}
+    , m_loopStopped(false)
     , m_loopInitialized(false)
+    , m_initFinished(false)
+    , m_connectionCount(0)
+    , m_bufferPool(std::make_shared<CUVBufferPool>(config.readBufferCacheBytes))
+    , m_wakePending(false)
+    , m_busyPolling(false)
+    , m_queueCapacity(0)
+    , m_overflowPolicy(OverflowPolicy::BLOCK)
+    , m_queueDepth(0)
+    , m_queueHighWaterMark(0)
+    , m_blockedProducers(0)
+    , m_drainTaskBudget(config.drainTaskBudget)
+    , m_drainTimeBudgetUs(config.drainTimeBudgetUs)
+    , m_executedTaskCount(0)
+    , m_wakeupCount(0)
+    , m_drainCount(0)
+    , m_rejectedTaskCount(0)
+    , m_droppedTaskCount(0)
+    , m_truncatedDrainCount(0)
+    , m_busyPollSpinCount(0)
+    , m_busyPollBlockCount(0)
+    , m_metricsEnabled(false)
+    , m_lagProbeExpected(0)
+    , m_sampledLoopCount(0)
+    , m_sampledEvents(0)
+    , m_sampledWaiting(0)
+    , m_sampledIdleTime(0)
+    , m_sampledTime(0)
+    , m_lastScrapeTime(0)
+    , m_lastScrapeIdleTime(0)
 {
     // 启动工作线程
     m_workerThread = new std::thread(workerThread, this);
     
     // 等待直到工作线程初始化完成
     std::unique_lock<std::mutex> lock(m_mutex);
-    m_condition.wait(lock, [this] { return m_loopInitialized; });
-    
+    m_condition.wait(lock, [this] { return m_initFinished; });
+
     // 如果初始化失败，清理资源
     if (m_loopInitialized == false) {
         m_isStopping = true;
+        lock.unlock();
         if (m_workerThread != nullptr && m_workerThread->joinable()) {
             m_workerThread->join();
             delete m_workerThread;
@@ -30,32 +103,77 @@ CUVLoop::CUVLoop()
         }
         return;
     }
+    lock.unlock();
+
+    // 应用队列相关的配置
+    if (m_config.taskQueueCapacity > 0) {
+        setTaskQueueCapacity(m_config.taskQueueCapacity, m_config.overflowPolicy);
+    }
+    if (m_config.metricsEnabled) {
+        setMetricsEnabled(true);
+    }
 }
 
 // 析构函数
 CUVLoop::~CUVLoop()
 {
+    // 前置条件：不在事件循环线程中析构，否则无法等待工作线程退出，
+    // 返回后工作线程会继续使用已释放的对象
+    assert(!isInLoopThread());
+
+    // 未排空关闭过时直接丢弃剩余任务
+    shutdown(0);
+
+    // 释放全部定时任务节点
+    for (TimerNode *node : m_timerNodes) {
+        delete node;
+    }
+    m_timerNodes.clear();
+
+    // std::cout << "CUVLoop: Event loop stopped and resources cleaned up." << std::endl;
+}
+
+// 排空后关闭事件循环
+CUVLoop::ShutdownReport CUVLoop::shutdown(uint64_t timeoutMs)
+{
+    if (m_workerThread == nullptr || isInLoopThread()) {
+        return ShutdownReport{false, 0, 0, 0, 0};
+    }
+
+    // 先进入排空阶段再停止，保证循环线程中的任务可以继续投递后续任务
+    m_drainTimeoutMs = timeoutMs;
+    m_isDraining = timeoutMs > 0;
     m_isStopping = true;
 
+    // 唤醒所有被阻塞的生产者
+    if (size_t blocked = m_blockedProducers.load()) {
+        m_spaceAvailable.signal(static_cast<ssize_t>(blocked));
+    }
+
     // 如果loop已经初始化，通过异步退出句柄触发安全停止
     if (m_loop) {
         uv_async_send(&m_asyncExit);
     }
 
     // 等待工作线程完成所有清理工作
-    if (m_workerThread != nullptr && m_workerThread->joinable()) {
+    if (m_workerThread->joinable()) {
         m_workerThread->join();
-        delete m_workerThread;
-        m_workerThread = nullptr;
     }
+    delete m_workerThread;
+    m_workerThread = nullptr;
 
-    // std::cout << "CUVLoop: Event loop stopped and resources cleaned up." << std::endl;
+    return m_shutdownReport;
 }
 
 // 内部工作线程函数
 void CUVLoop::workerThread(void *arg)
 {
     CUVLoop *loop = static_cast<CUVLoop *>(arg);
+    loop->m_loopThreadId = std::this_thread::get_id();
+    loop->m_bufferPool->setOwnerThread(loop->m_loopThreadId);
+
+    // 在进入事件循环之前设置线程名、CPU亲和性和调度策略
+    loop->m_threadConfigError = loop->applyThreadConfig();
 
     // 初始化libuv循环
     loop->m_loop = new uv_loop_t;
@@ -63,6 +181,14 @@ void CUVLoop::workerThread(void *arg)
         delete loop->m_loop;
         loop->m_loop = nullptr;
         loop->m_isStopping = true;
+
+        // 通知主线程初始化失败
+        {
+            std::lock_guard<std::mutex> lock(loop->m_mutex);
+            loop->m_loopInitialized = false;
+            loop->m_initFinished = true;
+            loop->m_condition.notify_one();
+        }
         return;
     }
 
@@ -70,32 +196,50 @@ void CUVLoop::workerThread(void *arg)
     loop->m_asyncExit.data = loop;
     int exitInitResult = uv_async_init(loop->m_loop, &loop->m_asyncExit, [](uv_async_t *handle) {
         CUVLoop *loop = static_cast<CUVLoop *>(handle->data);
+        loop->m_drainStartTime = uv_hrtime();
+        loop->m_drainStartExecuted = loop->m_executedTaskCount.load(std::memory_order_relaxed);
 
-        // 清理所有未处理的任务
-        Task task;
-        while (loop->m_taskQueue.try_dequeue(task)) {
-            // 任务对象会被自动销毁
+        // 排空关闭时继续运行事件循环，由定时器检查排空进度
+        if (uint64_t timeoutMs = loop->m_drainTimeoutMs.load()) {
+            loop->m_drainDeadline = loop->m_drainStartTime + timeoutMs * 1000000;
+            uv_timer_start(&loop->m_drainTimer, onDrainProbe, 0, kDrainPollIntervalMs);
+            return;
         }
 
-        // 停止libuv循环
-        uv_stop(handle->loop);
+        // 否则直接丢弃所有未处理的任务并停止
+        loop->finishShutdown();
     });
 
     // 初始化异步任务处理句柄
     loop->m_asyncWork.data = loop;
     int workInitResult = uv_async_init(loop->m_loop, &loop->m_asyncWork, [](uv_async_t *handle) {
-        CUVLoop *loop = static_cast<CUVLoop *>(handle->data);
-
-        Task task;
-        while (loop->m_taskQueue.try_dequeue(task)) {
-            if (task) {
-                task();
-            }
-        }
+        static_cast<CUVLoop *>(handle->data)->drainTasks();
     });
 
+    // 初始化延迟探测定时器，开启指标采集时才启动，且不阻止循环退出
+    loop->m_lagTimer.data = loop;
+    int timerInitResult = uv_timer_init(loop->m_loop, &loop->m_lagTimer);
+    if (timerInitResult == 0) {
+        uv_unref(reinterpret_cast<uv_handle_t *>(&loop->m_lagTimer));
+    }
+
+    // 初始化排空关闭的进度检查定时器
+    loop->m_drainTimer.data = loop;
+    int drainTimerInitResult = uv_timer_init(loop->m_loop, &loop->m_drainTimer);
+
+    // 初始化共享时间轮
+    int wheelInitResult = loop->m_timingWheel.init(loop->m_loop);
+
+    // 初始化循环末尾回调节点的check句柄，有节点登记时才启动，且不阻止循环退出
+    loop->m_flushCheck.data = loop;
+    int flushInitResult = uv_check_init(loop->m_loop, &loop->m_flushCheck);
+    if (flushInitResult == 0) {
+        uv_unref(reinterpret_cast<uv_handle_t *>(&loop->m_flushCheck));
+    }
+
     // 检查初始化结果
-    if (exitInitResult != 0 || workInitResult != 0) {
+    if (exitInitResult != 0 || workInitResult != 0 || timerInitResult != 0
+        || drainTimerInitResult != 0 || wheelInitResult != 0 || flushInitResult != 0) {
         // std::cerr << "CUVLoop: Failed to initialize async handles" << std::endl;
         delete loop->m_loop;
         loop->m_loop = nullptr;
@@ -105,6 +249,7 @@ void CUVLoop::workerThread(void *arg)
         {
             std::lock_guard<std::mutex> lock(loop->m_mutex);
             loop->m_loopInitialized = false;
+            loop->m_initFinished = true;
             loop->m_condition.notify_one();
         }
         return;
@@ -114,15 +259,24 @@ void CUVLoop::workerThread(void *arg)
     {
         std::lock_guard<std::mutex> lock(loop->m_mutex);
         loop->m_loopInitialized = true;
+        loop->m_initFinished = true;
         loop->m_condition.notify_one();
     }
     
     // 运行libuv循环
-    uv_run(loop->m_loop, UV_RUN_DEFAULT);
+    if (loop->m_config.busyPoll) {
+        loop->runBusyPoll();
+    } else {
+        uv_run(loop->m_loop, UV_RUN_DEFAULT);
+    }
 
     // 关闭所有uv句柄
     uv_close(reinterpret_cast<uv_handle_t *>(&loop->m_asyncExit), [](uv_handle_t *) {});
     uv_close(reinterpret_cast<uv_handle_t *>(&loop->m_asyncWork), [](uv_handle_t *) {});
+    uv_close(reinterpret_cast<uv_handle_t *>(&loop->m_lagTimer), [](uv_handle_t *) {});
+    uv_close(reinterpret_cast<uv_handle_t *>(&loop->m_drainTimer), [](uv_handle_t *) {});
+    uv_close(reinterpret_cast<uv_handle_t *>(&loop->m_flushCheck), [](uv_handle_t *) {});
+    loop->m_timingWheel.close();
 
     // 处理所有剩余的事件，直到loop不再活跃
     while (uv_loop_alive(loop->m_loop)) {
@@ -135,13 +289,136 @@ void CUVLoop::workerThread(void *arg)
     loop->m_loop = nullptr;
 }
 
+// 应用线程配置
+std::string CUVLoop::applyThreadConfig()
+{
+    std::string error;
+    auto fail = [&error](const char *operation, long code) {
+        if (!error.empty()) {
+            error += "; ";
+        }
+        error += std::string(operation) + " failed: " + std::to_string(code);
+    };
+
+#ifdef _WIN32
+    if (!m_config.threadName.empty()) {
+        // SetThreadDescription从Windows 10 1607开始提供，动态查找以兼容旧系统
+        using SetThreadDescriptionFunc = HRESULT(WINAPI *)(HANDLE, PCWSTR);
+        auto setThreadDescription = reinterpret_cast<SetThreadDescriptionFunc>(
+            GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+        if (setThreadDescription) {
+            std::wstring name(m_config.threadName.begin(), m_config.threadName.end());
+            setThreadDescription(GetCurrentThread(), name.c_str());
+        }
+    }
+
+    if (!m_config.cpuAffinity.empty()) {
+        DWORD_PTR mask = 0;
+        for (int cpu : m_config.cpuAffinity) {
+            if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+                mask |= DWORD_PTR(1) << cpu;
+            }
+        }
+        if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+            fail("SetThreadAffinityMask", static_cast<long>(GetLastError()));
+        }
+    }
+
+    // Windows没有nice值，按区间映射为线程优先级
+    int priority = THREAD_PRIORITY_NORMAL;
+    if (m_config.realtime) {
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    } else if (m_config.niceness < 0) {
+        priority = m_config.niceness <= -10 ? THREAD_PRIORITY_HIGHEST
+                                            : THREAD_PRIORITY_ABOVE_NORMAL;
+    } else if (m_config.niceness > 0) {
+        priority = m_config.niceness >= 10 ? THREAD_PRIORITY_LOWEST
+                                           : THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    if (priority != THREAD_PRIORITY_NORMAL && !SetThreadPriority(GetCurrentThread(), priority)) {
+        fail("SetThreadPriority", static_cast<long>(GetLastError()));
+    }
+#else
+    if (!m_config.threadName.empty()) {
+#ifdef __APPLE__
+        int result = pthread_setname_np(m_config.threadName.c_str());
+#else
+        // Linux线程名最长15个字符
+        int result = pthread_setname_np(pthread_self(), m_config.threadName.substr(0, 15).c_str());
+#endif
+        if (result != 0) {
+            fail("pthread_setname_np", result);
+        }
+    }
+
+#ifdef __linux__
+    if (!m_config.cpuAffinity.empty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : m_config.cpuAffinity) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        if (int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+            fail("pthread_setaffinity_np", result);
+        }
+    }
+
+    if (m_config.realtime) {
+        sched_param param{};
+        param.sched_priority = std::clamp(m_config.realtimePriority,
+                                          sched_get_priority_min(SCHED_FIFO),
+                                          sched_get_priority_max(SCHED_FIFO));
+        if (int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param)) {
+            fail("pthread_setschedparam", result);
+        }
+    } else if (m_config.niceness != 0) {
+        // Linux上nice值按线程生效
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), m_config.niceness)
+            != 0) {
+            fail("setpriority", errno);
+        }
+    }
+#else
+    if (!m_config.cpuAffinity.empty() || m_config.realtime || m_config.niceness != 0) {
+        fail("thread scheduling configuration", -1);
+    }
+#endif
+#endif
+
+    return error;
+}
+
 // 获取单例实例
 CUVLoop *CUVLoop::getInstance()
 {
-    static CUVLoop instance;
+    static CUVLoop instance([] {
+        std::lock_guard<std::mutex> lock(s_defaultConfigMutex);
+        return s_defaultConfig;
+    }());
     return &instance;
 }
 
+// 设置全局实例的配置
+void CUVLoop::setDefaultConfig(const Config &config)
+{
+    std::lock_guard<std::mutex> lock(s_defaultConfigMutex);
+    s_defaultConfig = config;
+}
+
+// 获取创建时使用的配置
+const CUVLoop::Config &CUVLoop::getConfig() const
+{
+    return m_config;
+}
+
+// 获取应用线程配置时的错误信息
+std::string CUVLoop::getThreadConfigError() const
+{
+    return m_threadConfigError;
+}
+
 // 获取libuv循环指针
 uv_loop_t *CUVLoop::getLoop() const
 {
@@ -154,22 +431,791 @@ bool CUVLoop::isRunning() const
     return !m_isStopping.load();
 }
 
-// 向循环中提交任务（左值引用版本）
-void CUVLoop::postTask(const std::function<void()> &task)
+// 检查当前线程是否为事件循环线程
+bool CUVLoop::isInLoopThread() const
 {
-    if (!m_isStopping && m_loop) {
-        m_taskQueue.enqueue(task);
-        // 触发异步任务处理
-        uv_async_send(&m_asyncWork);
+    return std::this_thread::get_id() == m_loopThreadId;
+}
+
+// 获取共享时间轮
+CUVTimingWheel *CUVLoop::getTimingWheel()
+{
+    return &m_timingWheel;
+}
+
+// 获取读缓冲池
+CUVBufferPool *CUVLoop::getBufferPool()
+{
+    return m_bufferPool.get();
+}
+
+// 登记在本轮循环末尾执行的回调节点
+void CUVLoop::scheduleFlush(FlushHook *hook)
+{
+    if (hook->scheduled) {
+        return;
+    }
+
+    hook->scheduled = true;
+    if (m_flushHooks.empty()) {
+        uv_check_start(&m_flushCheck, onFlushCheck);
+    }
+    m_flushHooks.push_back(hook);
+}
+
+// 取消已登记的回调节点，只把节点置空，不移动其他节点
+void CUVLoop::cancelFlush(FlushHook *hook)
+{
+    if (!hook->scheduled) {
+        return;
     }
+
+    hook->scheduled = false;
+    std::replace(m_flushHooks.begin(), m_flushHooks.end(), hook, static_cast<FlushHook *>(nullptr));
+    std::replace(m_runningHooks.begin(),
+                 m_runningHooks.end(),
+                 hook,
+                 static_cast<FlushHook *>(nullptr));
+}
+
+// 向循环中提交任务（左值引用版本）
+bool CUVLoop::postTask(const std::function<void()> &task, TaskPriority priority)
+{
+    return postTask(CUVTask(task), priority);
 }
 
 // 向循环中提交任务（右值引用版本）
-void CUVLoop::postTask(std::function<void()> &&task)
+bool CUVLoop::postTask(std::function<void()> &&task, TaskPriority priority)
+{
+    return postTask(CUVTask(std::move(task)), priority);
+}
+
+// 向循环中提交任务（CUVTask版本）
+bool CUVLoop::postTask(CUVTask &&task, TaskPriority priority)
+{
+    if (priority == TaskPriority::HIGH) {
+        if (!isAcceptingTasks() || !m_loop) {
+            return false;
+        }
+        stampTask(task);
+        m_highTaskQueue.enqueue(std::move(task));
+        wakeup();
+        return true;
+    }
+    return enqueueTask(task, true);
+}
+
+// 尝试向循环中提交任务
+bool CUVLoop::tryPostTask(CUVTask &&task)
+{
+    return enqueueTask(task, false);
+}
+
+// 是否接受新任务
+bool CUVLoop::isAcceptingTasks() const
+{
+    return !m_isStopping.load() || (m_isDraining.load() && isInLoopThread());
+}
+
+// 延迟执行一个任务
+CUVLoop::TimerHandle CUVLoop::postDelayed(uint64_t delayMs, CUVTask &&task)
+{
+    return createTimer(delayMs, 0, std::move(task));
+}
+
+// 周期性执行一个任务
+CUVLoop::TimerHandle CUVLoop::postPeriodic(uint64_t intervalMs, CUVTask &&task)
+{
+    if (intervalMs == 0) {
+        intervalMs = 1;
+    }
+    return createTimer(intervalMs, intervalMs, std::move(task));
+}
+
+// 取消定时任务
+bool CUVLoop::cancelTimer(const TimerHandle &handle)
+{
+    TimerNode *node = handle.m_node;
+    if (!node) {
+        return false;
+    }
+
+    // 只有代数一致且尚未取消时才能取消，节点已被回收或一次性任务已开始执行时代数已经变化
+    uint64_t expected = handle.m_generation << 1;
+    if (!node->state.compare_exchange_strong(expected, expected | 1)) {
+        return false;
+    }
+
+    // 通知事件循环尽快把节点从时间轮中移除
+    if (isInLoopThread()) {
+        handleTimerCommand(node, handle.m_generation);
+    } else if (!m_isStopping && m_loop) {
+        m_timerCommands.enqueue(TimerCommand(node, handle.m_generation));
+        wakeup();
+    }
+    return true;
+}
+
+// 创建定时任务
+CUVLoop::TimerHandle CUVLoop::createTimer(uint64_t delayMs, uint64_t intervalMs, CUVTask &&task)
+{
+    if (!isAcceptingTasks() || !m_loop) {
+        return TimerHandle();
+    }
+
+    // 优先复用空闲节点
+    TimerNode *node = nullptr;
+    if (!m_freeTimerNodes.try_dequeue(node)) {
+        node = new TimerNode;
+        node->timer.callback = onTimerNodeExpired;
+        node->timer.data = node;
+        node->running = false;
+        node->state.store(0, std::memory_order_relaxed);
+        node->loop = this;
+
+        std::lock_guard<std::mutex> lock(m_timerNodesMutex);
+        m_timerNodes.push_back(node);
+    }
+
+    node->task = std::move(task);
+    node->delay = delayMs;
+    node->interval = intervalMs;
+    uint64_t generation = node->state.load(std::memory_order_relaxed) >> 1;
+
+    // 循环线程中直接调度，其他线程只需一次入队
+    if (isInLoopThread()) {
+        handleTimerCommand(node, generation);
+    } else {
+        m_timerCommands.enqueue(TimerCommand(node, generation));
+        wakeup();
+    }
+    return TimerHandle(node, generation);
+}
+
+// 处理一条定时任务命令
+void CUVLoop::handleTimerCommand(TimerNode *node, uint64_t generation)
+{
+    uint64_t state = node->state.load(std::memory_order_acquire);
+    if ((state >> 1) != generation) {
+        return;
+    }
+
+    if (state & 1) {
+        // 已取消：正在执行的周期任务由到期回调在执行结束后回收
+        if (!node->running) {
+            m_timingWheel.cancel(&node->timer);
+            recycleTimerNode(node);
+        }
+    } else if (!CUVTimingWheel::isScheduled(&node->timer) && !node->running) {
+        m_timingWheel.schedule(&node->timer, node->delay);
+    }
+}
+
+// 处理全部待处理的定时任务命令
+void CUVLoop::drainTimerCommands()
+{
+    TimerCommand commands[kDrainBatchSize];
+    size_t count;
+    while ((count = m_timerCommands.try_dequeue_bulk(commands, kDrainBatchSize)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            handleTimerCommand(commands[i].first, commands[i].second);
+        }
+    }
+}
+
+// 回收定时任务节点
+void CUVLoop::recycleTimerNode(TimerNode *node)
+{
+    uint64_t generation = (node->state.load(std::memory_order_relaxed) >> 1) + 1;
+    node->state.store(generation << 1, std::memory_order_release);
+    node->task.reset();
+    m_freeTimerNodes.enqueue(node);
+}
+
+// 时间轮到期回调
+void CUVLoop::onTimerNodeExpired(CUVTimingWheel::Timer *timer)
+{
+    TimerNode *node = static_cast<TimerNode *>(timer->data);
+    CUVLoop *loop = node->loop;
+
+    uint64_t state = node->state.load(std::memory_order_acquire);
+    if (state & 1) {
+        loop->recycleTimerNode(node);
+        return;
+    }
+
+    if (node->interval == 0) {
+        // 一次性任务：先递增代数占有节点，此后的取消都会失败
+        uint64_t generation = state >> 1;
+        if (!node->state.compare_exchange_strong(state, (generation + 1) << 1)) {
+            loop->recycleTimerNode(node);
+            return;
+        }
+        node->task();
+        node->task.reset();
+        loop->m_freeTimerNodes.enqueue(node);
+        return;
+    }
+
+    // 周期任务：执行结束后检查是否在执行期间被取消
+    node->running = true;
+    node->task();
+    node->running = false;
+    if (node->state.load(std::memory_order_acquire) & 1) {
+        loop->recycleTimerNode(node);
+        return;
+    }
+    loop->m_timingWheel.schedule(&node->timer, node->interval);
+}
+
+// 设置任务队列容量和溢出策略
+void CUVLoop::setTaskQueueCapacity(size_t capacity, OverflowPolicy policy)
 {
-    if (!m_isStopping && m_loop) {
+    m_overflowPolicy.store(policy);
+    m_queueCapacity.store(capacity);
+
+    // 容量变化后让被阻塞的生产者重新检查
+    if (size_t blocked = m_blockedProducers.load()) {
+        m_spaceAvailable.signal(static_cast<ssize_t>(blocked));
+    }
+}
+
+// 设置每次排空的普通任务预算
+void CUVLoop::setDrainBudget(size_t maxTasks, uint64_t maxMicros)
+{
+    m_drainTaskBudget.store(maxTasks);
+    m_drainTimeBudgetUs.store(maxMicros);
+}
+
+// 获取每次排空的任务数预算
+size_t CUVLoop::getDrainTaskBudget() const
+{
+    return m_drainTaskBudget.load(std::memory_order_relaxed);
+}
+
+// 获取每次排空的耗时预算
+uint64_t CUVLoop::getDrainTimeBudget() const
+{
+    return m_drainTimeBudgetUs.load(std::memory_order_relaxed);
+}
+
+// 获取当前任务队列深度
+size_t CUVLoop::getQueueDepth() const
+{
+    return m_queueDepth.load(std::memory_order_relaxed);
+}
+
+// 获取任务队列深度高水位
+size_t CUVLoop::getQueueHighWaterMark() const
+{
+    return m_queueHighWaterMark.load(std::memory_order_relaxed);
+}
+
+// 注册生产者句柄
+std::unique_ptr<CUVLoop::Producer> CUVLoop::createProducer()
+{
+    return std::unique_ptr<Producer>(new Producer(this));
+}
+
+// 将任务放入队列
+bool CUVLoop::enqueueTask(CUVTask &task, bool allowBlock, moodycamel::ProducerToken *token)
+{
+    if (!isAcceptingTasks() || !m_loop) {
+        return false;
+    }
+
+    if (!acquireSlot(allowBlock)) {
+        m_rejectedTaskCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    stampTask(task);
+    if (token) {
+        m_taskQueue.enqueue(*token, std::move(task));
+    } else {
         m_taskQueue.enqueue(std::move(task));
-        // 触发异步任务处理
+    }
+    // 触发异步任务处理
+    wakeup();
+    return true;
+}
+
+// 占用队列槽位
+bool CUVLoop::acquireSlot(bool allowBlock)
+{
+    size_t capacity = m_queueCapacity.load(std::memory_order_relaxed);
+    if (capacity == 0) {
+        updateHighWaterMark(m_queueDepth.fetch_add(1) + 1);
+        return true;
+    }
+
+    size_t depth = m_queueDepth.load();
+    for (;;) {
+        if (depth < capacity) {
+            if (m_queueDepth.compare_exchange_weak(depth, depth + 1)) {
+                updateHighWaterMark(depth + 1);
+                return true;
+            }
+            continue;
+        }
+
+        // 队列已满，按溢出策略处理
+        OverflowPolicy policy = m_overflowPolicy.load(std::memory_order_relaxed);
+        if (policy == OverflowPolicy::DROP_OLDEST) {
+            // 丢弃一个最早的任务并接管它的槽位
+            Task victim;
+            if (m_taskQueue.try_dequeue(victim)) {
+                m_droppedTaskCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        } else if (policy == OverflowPolicy::BLOCK && isInLoopThread()) {
+            // 事件循环线程自身阻塞将永远无法排空队列，允许暂时超出容量
+            updateHighWaterMark(m_queueDepth.fetch_add(1) + 1);
+            return true;
+        } else if (policy == OverflowPolicy::FAIL || !allowBlock) {
+            return false;
+        } else {
+            // 登记为阻塞生产者后再次检查深度，避免与消费者释放槽位的竞争
+            m_blockedProducers.fetch_add(1);
+            if (m_queueDepth.load() >= m_queueCapacity.load() && !m_isStopping) {
+                m_spaceAvailable.wait(kBlockWaitUs);
+            }
+            m_blockedProducers.fetch_sub(1);
+            if (m_isStopping) {
+                return false;
+            }
+        }
+
+        capacity = m_queueCapacity.load(std::memory_order_relaxed);
+        if (capacity == 0) {
+            updateHighWaterMark(m_queueDepth.fetch_add(1) + 1);
+            return true;
+        }
+        depth = m_queueDepth.load();
+    }
+}
+
+// 释放队列槽位
+void CUVLoop::releaseSlots(size_t count)
+{
+    m_queueDepth.fetch_sub(count);
+    if (size_t blocked = m_blockedProducers.load()) {
+        m_spaceAvailable.signal(static_cast<ssize_t>((std::min)(blocked, count)));
+    }
+}
+
+// 更新队列深度高水位
+void CUVLoop::updateHighWaterMark(size_t depth)
+{
+    size_t highWaterMark = m_queueHighWaterMark.load(std::memory_order_relaxed);
+    while (depth > highWaterMark
+           && !m_queueHighWaterMark.compare_exchange_weak(highWaterMark,
+                                                          depth,
+                                                          std::memory_order_relaxed)) {
+    }
+}
+
+// 唤醒事件循环
+void CUVLoop::wakeup()
+{
+    // 只有排空之后的第一个生产者需要发送唤醒，其余生产者的任务会在同一次排空中被处理；
+    // 忙轮询的循环线程正在自旋时会自行检查唤醒标志，不需要发送唤醒
+    if (!m_wakePending.exchange(true)) {
+        if (m_busyPolling.load()) {
+            return;
+        }
+        m_wakeupCount.fetch_add(1, std::memory_order_relaxed);
         uv_async_send(&m_asyncWork);
     }
 }
+
+// 批量排空任务队列
+void CUVLoop::drainTasks()
+{
+    // 先清除唤醒标志再出队，保证排空期间入队的任务会触发新的唤醒
+    m_wakePending.exchange(false, std::memory_order_acq_rel);
+    m_drainCount.fetch_add(1, std::memory_order_relaxed);
+
+    // 先处理定时任务的创建和取消
+    drainTimerCommands();
+
+    const size_t taskBudget = m_drainTaskBudget.load(std::memory_order_relaxed);
+    const uint64_t timeBudgetNs = m_drainTimeBudgetUs.load(std::memory_order_relaxed) * 1000;
+    const uint64_t startTime = timeBudgetNs > 0 ? uv_hrtime() : 0;
+
+    Task batch[kDrainBatchSize];
+    size_t executed = 0;
+    for (;;) {
+        // 严格优先：每批普通任务之前先排空高优先级队列
+        drainHighPriorityTasks(batch);
+
+        // 普通任务超出本次预算时让出循环处理I/O，并重新唤醒自己继续排空
+        if (executed > 0
+            && ((taskBudget > 0 && executed >= taskBudget)
+                || (timeBudgetNs > 0 && uv_hrtime() - startTime >= timeBudgetNs))) {
+            if (m_queueDepth.load(std::memory_order_relaxed) > 0) {
+                m_truncatedDrainCount.fetch_add(1, std::memory_order_relaxed);
+                wakeup();
+            }
+            break;
+        }
+
+        // 排空关闭超过截止时间后不再执行普通任务，由进度检查定时器结束关闭
+        if (m_drainDeadline != 0 && uv_hrtime() >= m_drainDeadline) {
+            break;
+        }
+
+        size_t count = m_taskQueue.try_dequeue_bulk(batch, kDrainBatchSize);
+        if (count == 0) {
+            break;
+        }
+        runTasks(batch, count);
+        executed += count;
+        releaseSlots(count);
+    }
+}
+
+// 排空高优先级任务队列
+void CUVLoop::drainHighPriorityTasks(CUVTask *batch)
+{
+    size_t count;
+    while ((count = m_highTaskQueue.try_dequeue_bulk(batch, kDrainBatchSize)) > 0) {
+        runTasks(batch, count);
+    }
+}
+
+// 执行一批任务
+void CUVLoop::runTasks(CUVTask *batch, size_t count)
+{
+    if (!m_metricsEnabled.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i]) {
+                batch[i]();
+                batch[i].reset();
+            }
+        }
+    } else {
+        // 上一个任务的结束时间即下一个任务的开始时间，每个任务只取一次时间
+        uint64_t start = uv_hrtime();
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i].enqueueTime() != 0 && start > batch[i].enqueueTime()) {
+                m_queueWaitHistogram.record(start - batch[i].enqueueTime());
+            }
+            if (batch[i]) {
+                batch[i]();
+                batch[i].reset();
+            }
+            uint64_t end = uv_hrtime();
+            m_taskExecHistogram.record(end - start);
+            start = end;
+        }
+    }
+    m_executedTaskCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+// 记录任务入队时间
+void CUVLoop::stampTask(CUVTask &task)
+{
+    if (m_metricsEnabled.load(std::memory_order_relaxed)) {
+        task.setEnqueueTime(uv_hrtime());
+    }
+}
+
+// 获取任务队列统计信息
+CUVLoop::Stats CUVLoop::getStats() const
+{
+    return Stats{m_executedTaskCount.load(std::memory_order_relaxed),
+                 m_wakeupCount.load(std::memory_order_relaxed),
+                 m_drainCount.load(std::memory_order_relaxed),
+                 m_queueDepth.load(std::memory_order_relaxed),
+                 m_highTaskQueue.size_approx(),
+                 m_queueHighWaterMark.load(std::memory_order_relaxed),
+                 m_rejectedTaskCount.load(std::memory_order_relaxed),
+                 m_droppedTaskCount.load(std::memory_order_relaxed),
+                 m_truncatedDrainCount.load(std::memory_order_relaxed),
+                 m_busyPollSpinCount.load(std::memory_order_relaxed),
+                 m_busyPollBlockCount.load(std::memory_order_relaxed)};
+}
+
+// 开启或关闭运行指标采集
+void CUVLoop::setMetricsEnabled(bool enabled)
+{
+    if (m_metricsEnabled.exchange(enabled) == enabled) {
+        return;
+    }
+
+    // 定时器只能在循环线程中操作
+    postTask(
+        [this, enabled]() {
+            if (enabled) {
+                uv_loop_configure(m_loop, UV_METRICS_IDLE_TIME);
+                m_lagProbeExpected = uv_hrtime() + kLagProbeIntervalMs * 1000000;
+                uv_timer_start(&m_lagTimer, onLagProbe, kLagProbeIntervalMs, kLagProbeIntervalMs);
+            } else {
+                uv_timer_stop(&m_lagTimer);
+            }
+        },
+        TaskPriority::HIGH);
+}
+
+// 是否已开启运行指标采集
+bool CUVLoop::isMetricsEnabled() const
+{
+    return m_metricsEnabled.load(std::memory_order_relaxed);
+}
+
+// 获取运行指标快照
+CUVLoop::Metrics CUVLoop::getMetrics()
+{
+    Metrics metrics{};
+    metrics.enabled = m_metricsEnabled.load(std::memory_order_relaxed);
+    metrics.loopCount = m_sampledLoopCount.load(std::memory_order_relaxed);
+    metrics.events = m_sampledEvents.load(std::memory_order_relaxed);
+    metrics.eventsWaiting = m_sampledWaiting.load(std::memory_order_relaxed);
+    metrics.loopLag = m_loopLagHistogram.snapshot(true);
+    metrics.queueWait = m_queueWaitHistogram.snapshot(true);
+    metrics.taskExecution = m_taskExecHistogram.snapshot(true);
+
+    // 以采样时刻而非当前时间计算区间，避免与空闲时间的采样错位
+    uint64_t sampledTime = m_sampledTime.load();
+    uint64_t idleTime = m_sampledIdleTime.load();
+    metrics.idleTime = idleTime;
+
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    if (m_lastScrapeTime != 0 && sampledTime > m_lastScrapeTime) {
+        metrics.interval = sampledTime - m_lastScrapeTime;
+        uint64_t idle = idleTime - m_lastScrapeIdleTime;
+        metrics.utilization = idle >= metrics.interval
+                                  ? 0.0
+                                  : 1.0 - static_cast<double>(idle) / metrics.interval;
+    }
+    m_lastScrapeTime = sampledTime;
+    m_lastScrapeIdleTime = idleTime;
+    return metrics;
+}
+
+// 延迟探测定时器回调
+void CUVLoop::onLagProbe(uv_timer_t *handle)
+{
+    CUVLoop *loop = static_cast<CUVLoop *>(handle->data);
+    uint64_t now = uv_hrtime();
+
+    // 定时器实际触发时间与预期时间之差即为事件循环被阻塞的时间
+    if (now > loop->m_lagProbeExpected) {
+        loop->m_loopLagHistogram.record(now - loop->m_lagProbeExpected);
+    } else {
+        loop->m_loopLagHistogram.record(0);
+    }
+    loop->m_lagProbeExpected = now + kLagProbeIntervalMs * 1000000;
+
+    // 采样libuv指标，供其他线程读取
+    uv_metrics_t info{};
+    if (uv_metrics_info(loop->m_loop, &info) == 0) {
+        loop->m_sampledLoopCount.store(info.loop_count, std::memory_order_relaxed);
+        loop->m_sampledEvents.store(info.events, std::memory_order_relaxed);
+        loop->m_sampledWaiting.store(info.events_waiting, std::memory_order_relaxed);
+    }
+    loop->m_sampledIdleTime.store(uv_metrics_idle_time(loop->m_loop));
+    loop->m_sampledTime.store(now);
+}
+
+// 排空关闭的进度检查
+void CUVLoop::onDrainProbe(uv_timer_t *handle)
+{
+    CUVLoop *loop = static_cast<CUVLoop *>(handle->data);
+
+    // 队列深度在任务执行完后才减少，为0时排空期间投递的后续任务也已入队或执行完毕
+    bool drained = loop->m_queueDepth.load() == 0 && loop->m_highTaskQueue.size_approx() == 0
+                   && loop->pendingWriteBytes() == 0;
+    if (drained || uv_hrtime() >= loop->m_drainDeadline) {
+        loop->finishShutdown();
+    }
+}
+
+// 统计libuv写队列中尚未写出的字节数
+size_t CUVLoop::pendingWriteBytes() const
+{
+    size_t bytes = 0;
+    uv_walk(
+        m_loop,
+        [](uv_handle_t *handle, void *arg) {
+            uv_handle_type type = uv_handle_get_type(handle);
+            if ((type == UV_TCP || type == UV_NAMED_PIPE || type == UV_TTY)
+                && !uv_is_closing(handle)) {
+                *static_cast<size_t *>(arg) += uv_stream_get_write_queue_size(
+                    reinterpret_cast<const uv_stream_t *>(handle));
+            }
+        },
+        &bytes);
+    return bytes;
+}
+
+// 结束关闭
+void CUVLoop::finishShutdown()
+{
+    // 之后循环线程中投递的任务也被拒绝
+    m_isDraining = false;
+    uv_timer_stop(&m_drainTimer);
+
+    // 清理所有未处理的任务
+    uint64_t dropped = 0;
+    Task task;
+    while (m_highTaskQueue.try_dequeue(task)) {
+        // 任务对象会被自动销毁
+        ++dropped;
+    }
+    while (m_taskQueue.try_dequeue(task)) {
+        // 任务对象会被自动销毁
+        releaseSlots(1);
+        ++dropped;
+    }
+
+    m_shutdownReport.unflushedBytes = pendingWriteBytes();
+    m_shutdownReport.completed = dropped == 0 && m_shutdownReport.unflushedBytes == 0;
+    m_shutdownReport.flushedTasks = m_executedTaskCount.load(std::memory_order_relaxed)
+                                    - m_drainStartExecuted;
+    m_shutdownReport.droppedTasks = dropped;
+    m_shutdownReport.elapsedMs = (uv_hrtime() - m_drainStartTime) / 1000000;
+
+    // 停止libuv循环
+    m_loopStopped = true;
+    uv_stop(m_loop);
+}
+
+// 循环末尾执行全部已登记的回调节点，回调中新登记的节点在本轮中继续执行，
+// 否则它们要等到下一次I/O事件或定时器之后才执行
+void CUVLoop::onFlushCheck(uv_check_t *handle)
+{
+    CUVLoop *loop = static_cast<CUVLoop *>(handle->data);
+
+    while (!loop->m_flushHooks.empty()) {
+        loop->m_runningHooks.swap(loop->m_flushHooks);
+        for (size_t i = 0; i < loop->m_runningHooks.size(); ++i) {
+            FlushHook *hook = loop->m_runningHooks[i];
+            if (hook) {
+                hook->scheduled = false;
+                hook->callback(hook);
+            }
+        }
+        loop->m_runningHooks.clear();
+    }
+
+    uv_check_stop(handle);
+}
+
+// 忙轮询模式的运行循环
+void CUVLoop::runBusyPoll()
+{
+    const uint64_t idleBudgetNs = m_config.busyPollIdleUs * 1000;
+    uint64_t idleSince = uv_hrtime();
+    uint64_t lastEvents = 0;
+    uv_metrics_t metrics;
+
+    m_busyPolling.store(true);
+    while (!m_loopStopped) {
+        // 自旋期间生产者只设置唤醒标志，由循环线程直接排空任务
+        bool active = false;
+        if (m_wakePending.load(std::memory_order_acquire)) {
+            drainTasks();
+            active = true;
+        }
+
+        uv_run(m_loop, UV_RUN_NOWAIT);
+        m_busyPollSpinCount.fetch_add(1, std::memory_order_relaxed);
+
+        // 套接字等I/O事件按事件提供者处理的事件数判断
+        if (uv_metrics_info(m_loop, &metrics) == 0 && metrics.events != lastEvents) {
+            lastEvents = metrics.events;
+            active = true;
+        }
+
+        uint64_t now = uv_hrtime();
+        if (active) {
+            idleSince = now;
+            continue;
+        }
+        if (now - idleSince < idleBudgetNs) {
+            continue;
+        }
+
+        // 空闲超出预算，退回阻塞等待；先撤销自旋标志再检查唤醒标志，
+        // 与wakeup()中的先设置唤醒标志再检查自旋标志配对，保证不会丢失唤醒
+        m_busyPolling.store(false);
+        if (!m_wakePending.load() && !m_loopStopped) {
+            m_busyPollBlockCount.fetch_add(1, std::memory_order_relaxed);
+            uv_run(m_loop, UV_RUN_ONCE);
+        }
+        m_busyPolling.store(true);
+        idleSince = uv_hrtime();
+    }
+    m_busyPolling.store(false);
+}
+
+// 登记连接
+void CUVLoop::addConnection()
+{
+    m_connectionCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 注销连接
+void CUVLoop::removeConnection()
+{
+    m_connectionCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// 获取连接数
+size_t CUVLoop::getConnectionCount() const
+{
+    return m_connectionCount.load(std::memory_order_relaxed);
+}
+
+// 获取当前负载
+size_t CUVLoop::getLoad() const
+{
+    return m_connectionCount.load(std::memory_order_relaxed)
+           + m_queueDepth.load(std::memory_order_relaxed);
+}
+
+// ==================== 生产者句柄 ====================
+
+CUVLoop::Producer::Producer(CUVLoop *loop)
+    : m_loop(loop)
+    , m_token(loop->m_taskQueue)
+{}
+
+// 投递一个任务
+bool CUVLoop::Producer::post(CUVTask &&task)
+{
+    return m_loop->enqueueTask(task, true, &m_token);
+}
+
+// 批量投递任务
+size_t CUVLoop::Producer::postBulk(CUVTask *tasks, size_t count)
+{
+    if (!m_loop->isAcceptingTasks() || !m_loop->m_loop || count == 0) {
+        return 0;
+    }
+
+    // 占用槽位，无容量限制时一次完成
+    size_t accepted = 0;
+    if (m_loop->m_queueCapacity.load(std::memory_order_relaxed) == 0) {
+        m_loop->updateHighWaterMark(m_loop->m_queueDepth.fetch_add(count) + count);
+        accepted = count;
+    } else {
+        while (accepted < count && m_loop->acquireSlot(true)) {
+            ++accepted;
+        }
+        if (accepted < count) {
+            m_loop->m_rejectedTaskCount.fetch_add(count - accepted, std::memory_order_relaxed);
+        }
+    }
+
+    if (accepted > 0) {
+        for (size_t i = 0; i < accepted; ++i) {
+            m_loop->stampTask(tasks[i]);
+        }
+        m_loop->m_taskQueue.enqueue_bulk(m_token, std::make_move_iterator(tasks), accepted);
+        m_loop->wakeup();
+    }
+    return accepted;
+}
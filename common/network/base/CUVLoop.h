@@ -1,23 +1,234 @@
 #ifndef CUVLOOP_H
 #define CUVLOOP_H
 
+#include "CLatencyHistogram.h"
+#include "CUVBufferPool.h"
+#include "CUVFuture.h"
+#include "CUVTask.h"
+#include "CUVTimingWheel.h"
 #include "concurrentqueue.h"
+#include "lightweightsemaphore.h"
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
 #include <uv.h>
+#include <vector>
 
 namespace Common {
 namespace Network {
 
 /**
  * @brief 事件循环类，封装了libuv的事件循环功能
- * @details 采用单例模式，自动管理工作线程的启动和停止
- *          用户无需手动调用start()和stop()方法
+ * @details 构造时启动工作线程，析构时停止，用户无需手动调用start()和stop()方法；
+ *          getInstance()提供一个全局默认实例，也可以自行创建多个相互隔离的实例，
+ *          例如把延迟敏感的控制流量和大批量遥测流量放在不同的循环上
  */
 class CUVLoop
 {
+public:
+    /**
+     * @brief 任务优先级
+     */
+    enum class TaskPriority {
+        HIGH,  // 控制类任务（连接、断开、定时器、停止），优先执行且不受队列容量限制
+        NORMAL // 普通任务（如数据发送）
+    };
+
+    /**
+     * @brief 任务队列满时的处理策略
+     */
+    enum class OverflowPolicy {
+        BLOCK,      // 阻塞生产者直到队列有空位
+        FAIL,       // 立即拒绝新任务
+        DROP_OLDEST // 丢弃队列中最早的任务（多生产者时为近似最早），被丢弃的任务在投递线程中销毁
+    };
+
+    /**
+     * @brief 任务队列统计信息
+     */
+    struct Stats
+    {
+        uint64_t executedTasks;   // 已执行的任务数
+        uint64_t wakeups;         // 实际发出的唤醒次数（uv_async_send调用次数）
+        uint64_t drains;          // 任务队列排空回调的执行次数
+        size_t pendingTasks;      // 当前待处理的普通任务数
+        size_t pendingHighTasks;  // 当前待处理的高优先级任务数（近似值）
+        size_t highWaterMark;     // 任务队列深度的历史最大值
+        uint64_t rejectedTasks;   // 因队列满被拒绝的任务数
+        uint64_t droppedTasks;    // 因DROP_OLDEST策略被丢弃的任务数
+        uint64_t truncatedDrains; // 因超出预算而提前结束的排空次数
+        uint64_t busyPollSpins;   // 忙轮询模式下的自旋次数（uv_run(UV_RUN_NOWAIT)调用次数）
+        uint64_t busyPollBlocks;  // 忙轮询模式下空闲超出预算、退回阻塞等待的次数
+    };
+
+    /**
+     * @brief 事件循环运行指标，时间单位均为纳秒
+     * @details 累计值来自uv_metrics_info和uv_metrics_idle_time，由延迟探测定时器在循环线程中采样；
+     *          直方图与利用率为两次getMetrics()调用之间的区间统计；
+     *          空闲循环上的任务排队时间即唤醒到处理的延迟，可用于比较忙轮询与阻塞两种模式
+     */
+    struct Metrics
+    {
+        bool enabled;                              // 是否已开启指标采集
+        uint64_t loopCount;                        // 事件循环迭代次数
+        uint64_t events;                           // 事件提供者处理的事件数
+        uint64_t eventsWaiting;                    // 事件提供者被调用时等待处理的事件数
+        uint64_t idleTime;                         // 累计在事件提供者中空闲等待的时间
+        uint64_t interval;                         // 与上一次采集的时间间隔
+        double utilization;                        // 区间内的循环利用率，0~1
+        CLatencyHistogram::Snapshot loopLag;       // 事件循环延迟（定时器实际触发与预期时间之差）
+        CLatencyHistogram::Snapshot queueWait;     // 任务排队时间（入队到开始执行）
+        CLatencyHistogram::Snapshot taskExecution; // 任务执行时间
+    };
+
+    /**
+     * @brief 排空关闭报告
+     */
+    struct ShutdownReport
+    {
+        bool completed;        // 是否在截止时间前排空了任务队列和libuv写队列
+        uint64_t flushedTasks; // 关闭期间执行的任务数
+        uint64_t droppedTasks; // 截止时仍未执行而被丢弃的任务数
+        size_t unflushedBytes; // 截止时仍留在libuv写队列中的字节数
+        uint64_t elapsedMs;    // 关闭耗时，单位毫秒
+    };
+
+    static constexpr size_t kDefaultDrainTaskBudget = 4096; // 默认每次排空的普通任务预算
+
+    /**
+     * @brief 事件循环配置，在工作线程进入uv_run之前生效
+     * @details 线程相关的设置尽力而为，失败的项目可通过getThreadConfigError()查询；
+     *          CPU亲和性在Linux和Windows上有效，实时调度和nice值仅在Linux上有效
+     *          （Windows上映射为线程优先级），通常需要CAP_SYS_NICE或相应权限；
+     *          忙轮询模式在有任务或I/O事件时以UV_RUN_NOWAIT自旋，生产者不再发送唤醒，
+     *          省去eventfd写入和epoll_wait休眠，代价是占满一个CPU核心，宜与cpuAffinity配合使用
+     */
+    struct Config
+    {
+        std::string threadName;       // 线程名，空表示不设置（Linux上超出15个字符的部分被截断）
+        std::vector<int> cpuAffinity; // 允许运行的CPU编号，空表示不绑定
+        bool realtime = false;        // 是否使用SCHED_FIFO实时调度
+        int realtimePriority = 1;     // 实时调度优先级
+        int niceness = 0;             // nice值，0表示不调整，仅在非实时调度时生效
+
+        size_t taskQueueCapacity = 0;                          // 任务队列容量，0表示不限制
+        OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK; // 队列满时的处理策略
+        size_t drainTaskBudget = kDefaultDrainTaskBudget;      // 每次排空的普通任务预算
+        uint64_t drainTimeBudgetUs = 0;                        // 每次排空的耗时预算，单位微秒
+        bool metricsEnabled = false;                           // 是否开启运行指标采集
+
+        bool busyPoll = false;         // 是否使用忙轮询模式
+        uint64_t busyPollIdleUs = 100; // 忙轮询连续空闲超过该时间后退回阻塞等待，单位微秒
+
+        // 读缓冲池每个尺寸等级最多缓存的字节数
+        size_t readBufferCacheBytes = CUVBufferPool::kDefaultMaxCachedBytes;
+    };
+
+    struct TimerNode;
+
+    /**
+     * @brief 定时任务句柄，用于取消postDelayed()/postPeriodic()创建的定时任务
+     * @details 句柄只是节点指针和代数的组合，可以随意复制；定时任务结束后句柄自动失效
+     */
+    class TimerHandle
+    {
+        friend class CUVLoop;
+
+    public:
+        TimerHandle()
+            : m_node(nullptr)
+            , m_generation(0)
+        {}
+
+        /**
+         * @brief 是否指向一个定时任务（不代表该任务仍未结束）
+         */
+        explicit operator bool() const { return m_node != nullptr; }
+
+    private:
+        TimerHandle(TimerNode *node, uint64_t generation)
+            : m_node(node)
+            , m_generation(generation)
+        {}
+
+        TimerNode *m_node;     // 定时任务节点
+        uint64_t m_generation; // 创建时节点的代数，节点回收后代数递增，旧句柄随之失效
+    };
+
+    /**
+     * @brief 长期存在的生产者句柄
+     * @details 封装moodycamel::ProducerToken，入队时不再查找线程局部的隐式生产者，
+     *          同一个句柄投递的任务按FIFO顺序执行，并支持批量投递；
+     *          句柄只能由一个线程使用，且必须在所属CUVLoop销毁之前销毁
+     */
+    class Producer
+    {
+        friend class CUVLoop;
+
+    public:
+        // 禁止拷贝构造和赋值操作
+        Producer(const Producer &) = delete;
+        Producer &operator=(const Producer &) = delete;
+
+        /**
+         * @brief 投递一个任务
+         * @param task 任务对象，被拒绝时保持不变
+         * @return 任务是否被接受
+         */
+        bool post(CUVTask &&task);
+
+        /**
+         * @brief 投递任意可调用对象
+         * @param func 可调用对象
+         * @return 任务是否被接受
+         */
+        template<typename Func,
+                 typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+        bool post(Func &&func)
+        {
+            return post(CUVTask(std::forward<Func>(func)));
+        }
+
+        /**
+         * @brief 批量投递任务，只触发一次唤醒
+         * @param tasks 任务数组，被接受的任务会被移走
+         * @param count 任务数量
+         * @return 被接受的任务数，从数组开头算起
+         */
+        size_t postBulk(CUVTask *tasks, size_t count);
+
+    private:
+        explicit Producer(CUVLoop *loop);
+
+        CUVLoop *m_loop;                   // 所属事件循环
+        moodycamel::ProducerToken m_token; // 生产者令牌
+    };
+
+    /**
+     * @brief 本轮循环末尾执行一次的回调节点，由使用者持有，在被登记期间不能销毁
+     * @details 用于把同一轮循环中的多次操作合并到循环末尾一次完成，例如合并同一连接的写请求；
+     *          节点在I/O回调之后的check阶段执行，回调中再次登记的节点在同一轮中继续执行；
+     *          句柄关闭回调中登记的节点要等到下一轮循环才执行
+     */
+    struct FlushHook
+    {
+        using Callback = void (*)(FlushHook *hook); // 执行回调类型
+
+        Callback callback = nullptr; // 执行回调
+        void *data = nullptr;        // 用户数据
+
+    private:
+        friend class CUVLoop;
+
+        bool scheduled = false; // 是否已登记
+    };
+
 private:
     /**
      * @brief 内部工作线程函数
@@ -25,22 +236,74 @@ private:
      */
     static void workerThread(void *arg);
 
-private:
-    // 私有构造函数，防止直接实例化
+    /**
+     * @brief 在工作线程中应用线程名、CPU亲和性和调度策略
+     * @return 错误信息，全部成功时为空
+     */
+    std::string applyThreadConfig();
+
+public:
+    /**
+     * @brief 构造函数，创建并启动一个独立的事件循环
+     * @details 构造返回时工作线程已进入初始化完成状态，可以直接投递任务；
+     *          除getInstance()返回的全局实例外，事件循环由创建者持有，
+     *          必须在挂载在其上的服务器、客户端销毁之后再销毁
+     */
     CUVLoop();
+
+    /**
+     * @brief 按配置构造
+     * @param config 事件循环配置
+     */
+    explicit CUVLoop(const Config &config);
+
+    /**
+     * @brief 析构函数，停止事件循环并等待工作线程退出
+     * @details 未调用过shutdown()时，队列中未执行的任务被丢弃；
+     *          前置条件：不能在事件循环线程中析构（调试版本中断言检查）
+     */
     ~CUVLoop();
 
     // 禁止拷贝构造和赋值操作
     CUVLoop(const CUVLoop &) = delete;
     CUVLoop &operator=(const CUVLoop &) = delete;
 
-public:
     /**
-     * @brief 获取全局唯一的事件循环实例
+     * @brief 获取全局默认的事件循环实例
      * @return CUVLoop实例指针
      */
     static CUVLoop *getInstance();
 
+    /**
+     * @brief 设置全局事件循环实例的配置
+     * @details 必须在第一次调用getInstance()之前设置，之后的设置无效
+     * @param config 事件循环配置
+     */
+    static void setDefaultConfig(const Config &config);
+
+    /**
+     * @brief 获取创建时使用的配置
+     * @return 事件循环配置
+     */
+    const Config &getConfig() const;
+
+    /**
+     * @brief 获取应用线程配置时的错误信息
+     * @return 错误信息，全部成功时为空
+     */
+    std::string getThreadConfigError() const;
+
+    /**
+     * @brief 排空后关闭事件循环，并等待工作线程退出
+     * @details 调用后不再接受其他线程投递的任务，排空阶段事件循环线程中的任务仍可继续投递后续任务；
+     *          事件循环继续处理I/O，直到任务队列为空且libuv写队列全部写出，或者超过截止时间，
+     *          之后丢弃剩余任务并停止；挂载在其上的服务器、客户端应在此之前先停止或排空；
+     *          在事件循环线程中调用时不做任何处理，与重复调用一样返回空报告
+     * @param timeoutMs 排空的最长时间，单位毫秒，0表示直接丢弃剩余任务
+     * @return 关闭报告
+     */
+    ShutdownReport shutdown(uint64_t timeoutMs);
+
     /**
      * @brief 检查事件循环是否正在运行
      * @return 是否正在运行
@@ -53,34 +316,485 @@ public:
      */
     uv_loop_t *getLoop() const;
 
+    /**
+     * @brief 检查当前线程是否为事件循环线程
+     * @return 是否为事件循环线程
+     */
+    bool isInLoopThread() const;
+
+    /**
+     * @brief 获取事件循环共享的时间轮，用于连接超时等大量定时器
+     * @details 时间轮只能在事件循环线程中使用
+     * @return 时间轮指针
+     */
+    CUVTimingWheel *getTimingWheel();
+
+    /**
+     * @brief 获取事件循环的读缓冲池，用于连接的读取回调
+     * @details acquire()只能在事件循环线程中调用，缓冲池随事件循环销毁，
+     *          通过CUVBufferPool::Buffer转交出去的缓冲区仍可安全归还
+     * @return 缓冲池指针
+     */
+    CUVBufferPool *getBufferPool();
+
+    /**
+     * @brief 登记在本轮循环末尾执行的回调节点，已登记时无操作
+     * @details 只能在事件循环线程中调用，节点的callback必须已设置
+     * @param hook 回调节点
+     */
+    void scheduleFlush(FlushHook *hook);
+
+    /**
+     * @brief 取消已登记的回调节点，未登记时无操作，只能在事件循环线程中调用
+     * @param hook 回调节点
+     */
+    void cancelFlush(FlushHook *hook);
+
     /**
      * @brief 向事件循环中提交一个任务
+     * @details 普通任务在队列有容量限制时按溢出策略处理，BLOCK策略下会阻塞调用线程；
+     *          高优先级任务进入独立的队列，总是先于普通任务执行
      * @param task 任务回调函数
+     * @param priority 任务优先级
+     * @return 任务是否被接受
      */
-    void postTask(const std::function<void()> &task);
+    bool postTask(const std::function<void()> &task,
+                  TaskPriority priority = TaskPriority::NORMAL);
 
     /**
      * @brief 向事件循环中提交一个任务（右值引用版本）
      * @param task 任务回调函数
+     * @param priority 任务优先级
+     * @return 任务是否被接受
+     */
+    bool postTask(std::function<void()> &&task, TaskPriority priority = TaskPriority::NORMAL);
+
+    /**
+     * @brief 向事件循环中提交一个任务（CUVTask版本）
+     * @param task 任务对象，被拒绝时保持不变
+     * @param priority 任务优先级
+     * @return 任务是否被接受
+     */
+    bool postTask(CUVTask &&task, TaskPriority priority = TaskPriority::NORMAL);
+
+    /**
+     * @brief 向事件循环中提交任意可调用对象
+     * @details 可调用对象直接构造在CUVTask的内联存储中，不经过std::function类型擦除
+     * @param func 可调用对象
+     * @param priority 任务优先级
+     * @return 任务是否被接受
+     */
+    template<typename Func,
+             typename = std::enable_if_t<
+                 !std::is_same<std::decay_t<Func>, CUVTask>::value
+                 && !std::is_same<std::decay_t<Func>, std::function<void()>>::value>>
+    bool postTask(Func &&func, TaskPriority priority = TaskPriority::NORMAL)
+    {
+        return postTask(CUVTask(std::forward<Func>(func)), priority);
+    }
+
+    /**
+     * @brief 尝试向事件循环中提交一个任务，从不阻塞
+     * @details 队列已满时，除DROP_OLDEST策略外直接返回false
+     * @param task 任务对象，被拒绝时保持不变
+     * @return 任务是否被接受
+     */
+    bool tryPostTask(CUVTask &&task);
+
+    /**
+     * @brief 尝试向事件循环中提交任意可调用对象，从不阻塞
+     * @param func 可调用对象
+     * @return 任务是否被接受
+     */
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+    bool tryPostTask(Func &&func)
+    {
+        return tryPostTask(CUVTask(std::forward<Func>(func)));
+    }
+
+    /**
+     * @brief 向事件循环中提交一个有返回值的任务
+     * @details 结果通过CUVFuture取得，共享状态与CUVPromise一次分配，可调用对象仍内联在CUVTask中；
+     *          任务被拒绝或因事件循环停止而未执行时，CUVFuture处于被丢弃状态
+     * @param func 可调用对象
+     * @param priority 任务优先级
+     * @return 结果句柄
+     */
+    template<typename Func, typename Result = std::invoke_result_t<std::decay_t<Func> &>>
+    CUVFuture<Result> submit(Func &&func, TaskPriority priority = TaskPriority::NORMAL)
+    {
+        CUVPromise<Result> promise;
+        CUVFuture<Result> future = promise.getFuture();
+        postTask(CUVTask([promise = std::move(promise), func = std::forward<Func>(func)]() mutable {
+                     if constexpr (std::is_void<Result>::value) {
+                         func();
+                         promise.setValue();
+                     } else {
+                         promise.setValue(func());
+                     }
+                 }),
+                 priority);
+        return future;
+    }
+
+    /**
+     * @brief 延迟执行一个任务
+     * @details 定时任务由事件循环的时间轮驱动，精度为1毫秒；在非循环线程中调用时只有一次入队，
+     *          定时任务节点从节点池中复用，稳定运行后不再分配内存；定时任务不受任务队列容量限制
+     * @param delayMs 延迟，单位毫秒
+     * @param task 任务对象
+     * @return 定时任务句柄，事件循环已停止时为空句柄
+     */
+    TimerHandle postDelayed(uint64_t delayMs, CUVTask &&task);
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+    TimerHandle postDelayed(uint64_t delayMs, Func &&func)
+    {
+        return postDelayed(delayMs, CUVTask(std::forward<Func>(func)));
+    }
+
+    /**
+     * @brief 周期性执行一个任务，直到被取消
+     * @details 每次执行结束后按间隔重新计时，执行耗时不会导致任务堆积
+     * @param intervalMs 周期，单位毫秒，0按1毫秒处理
+     * @param task 任务对象
+     * @return 定时任务句柄，事件循环已停止时为空句柄
+     */
+    TimerHandle postPeriodic(uint64_t intervalMs, CUVTask &&task);
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+    TimerHandle postPeriodic(uint64_t intervalMs, Func &&func)
+    {
+        return postPeriodic(intervalMs, CUVTask(std::forward<Func>(func)));
+    }
+
+    /**
+     * @brief 取消定时任务，可在任意线程中调用
+     * @details 取消后任务不会再开始执行；一次性任务已开始执行时取消失败
+     * @param handle 定时任务句柄
+     * @return 是否取消成功，任务已结束、已取消或句柄为空时返回false
+     */
+    bool cancelTimer(const TimerHandle &handle);
+
+    /**
+     * @brief 为长期存在的生产者线程注册一个生产者句柄
+     * @return 生产者句柄
+     */
+    std::unique_ptr<Producer> createProducer();
+
+    /**
+     * @brief 设置任务队列容量和溢出策略
+     * @param capacity 队列容量，0表示不限制
+     * @param policy 队列满时的处理策略
+     */
+    void setTaskQueueCapacity(size_t capacity, OverflowPolicy policy = OverflowPolicy::BLOCK);
+
+    /**
+     * @brief 设置每次排空的普通任务预算
+     * @details 超出任务数或耗时预算时，本次排空提前结束，事件循环先处理I/O和定时器，
+     *          再继续排空剩余任务，以保证发送风暴期间的读取延迟有上限；
+     *          高优先级任务不受预算限制
+     * @param maxTasks 每次排空最多执行的普通任务数，0表示不限制
+     * @param maxMicros 每次排空最长耗时，单位微秒，0表示不限制
+     */
+    void setDrainBudget(size_t maxTasks, uint64_t maxMicros = 0);
+
+    /**
+     * @brief 获取每次排空最多执行的普通任务数
+     * @return 任务数预算，0表示不限制
+     */
+    size_t getDrainTaskBudget() const;
+
+    /**
+     * @brief 获取每次排空的最长耗时
+     * @return 耗时预算，单位微秒，0表示不限制
+     */
+    uint64_t getDrainTimeBudget() const;
+
+    /**
+     * @brief 获取当前任务队列深度
+     * @return 队列中尚未执行的任务数
+     */
+    size_t getQueueDepth() const;
+
+    /**
+     * @brief 获取任务队列深度的历史最大值
+     * @return 队列深度高水位
+     */
+    size_t getQueueHighWaterMark() const;
+
+    /**
+     * @brief 登记一个挂载到本循环上的连接（用于负载统计）
+     */
+    void addConnection();
+
+    /**
+     * @brief 注销一个挂载到本循环上的连接（用于负载统计）
      */
-    void postTask(std::function<void()> &&task);
+    void removeConnection();
+
+    /**
+     * @brief 获取挂载到本循环上的连接数
+     * @return 连接数
+     */
+    size_t getConnectionCount() const;
+
+    /**
+     * @brief 获取当前负载（连接数 + 待处理任务数）
+     * @return 负载值
+     */
+    size_t getLoad() const;
+
+    /**
+     * @brief 获取任务队列统计信息，用于评估唤醒合并的效果
+     * @return 统计信息
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 开启或关闭运行指标采集
+     * @details 开启后记录每个任务的入队时间，每次执行任务多一次取时操作，
+     *          并启动周期为kLagProbeIntervalMs的延迟探测定时器；默认关闭
+     * @param enabled 是否开启
+     */
+    void setMetricsEnabled(bool enabled);
+
+    /**
+     * @brief 是否已开启运行指标采集
+     */
+    bool isMetricsEnabled() const;
+
+    /**
+     * @brief 获取运行指标快照，可由采集线程每秒调用一次
+     * @details 读取后直方图清零，多个采集者同时调用时会互相分走样本
+     * @return 运行指标
+     */
+    Metrics getMetrics();
 
 private:
-    uv_loop_t *m_loop;              // libuv事件循环指针
-    std::thread *m_workerThread;    // 工作线程指针
-    std::atomic<bool> m_isStopping; // 停止标志
-    
+    static constexpr size_t kDrainBatchSize = 64; // 每次批量出队的任务数
+
+    static constexpr int64_t kBlockWaitUs = 10000;      // 阻塞生产者单次等待的最长时间，单位微秒
+    static constexpr uint64_t kLagProbeIntervalMs = 10; // 延迟探测定时器周期，单位毫秒
+    static constexpr uint64_t kDrainPollIntervalMs = 1; // 排空关闭时检查进度的周期，单位毫秒
+
+    /**
+     * @brief 是否接受新任务
+     * @details 停止后只接受排空阶段事件循环线程自身投递的任务
+     */
+    bool isAcceptingTasks() const;
+
+    /**
+     * @brief 将任务放入队列，被拒绝时task保持不变
+     * @param task 任务对象
+     * @param allowBlock 队列满且策略为BLOCK时是否允许阻塞
+     * @param token 生产者令牌，nullptr表示使用隐式生产者
+     * @return 任务是否被接受
+     */
+    bool enqueueTask(CUVTask &task, bool allowBlock, moodycamel::ProducerToken *token = nullptr);
+
+    /**
+     * @brief 为新任务占用一个队列槽位，按溢出策略处理队列已满的情况
+     * @param allowBlock 是否允许阻塞
+     * @return 是否成功占用槽位
+     */
+    bool acquireSlot(bool allowBlock);
+
+    /**
+     * @brief 释放已出队任务占用的槽位，并唤醒被阻塞的生产者
+     * @param count 出队的任务数
+     */
+    void releaseSlots(size_t count);
+
+    /**
+     * @brief 更新队列深度高水位
+     * @param depth 当前深度
+     */
+    void updateHighWaterMark(size_t depth);
+
+    /**
+     * @brief 唤醒事件循环处理任务，已有未处理的唤醒时不重复发送
+     */
+    void wakeup();
+
+    /**
+     * @brief 在事件循环线程中批量排空任务队列
+     */
+    void drainTasks();
+
+    /**
+     * @brief 排空高优先级任务队列
+     * @param batch 出队缓冲区
+     */
+    void drainHighPriorityTasks(CUVTask *batch);
+
+    /**
+     * @brief 创建定时任务
+     * @param delayMs 首次延迟
+     * @param intervalMs 周期，0表示一次性任务
+     * @param task 任务对象
+     * @return 定时任务句柄
+     */
+    TimerHandle createTimer(uint64_t delayMs, uint64_t intervalMs, CUVTask &&task);
+
+    /**
+     * @brief 在事件循环线程中处理一条定时任务命令（创建或取消）
+     * @param node 定时任务节点
+     * @param generation 命令发出时节点的代数，与节点当前代数不同表示命令已过期
+     */
+    void handleTimerCommand(TimerNode *node, uint64_t generation);
+
+    /**
+     * @brief 处理全部待处理的定时任务命令
+     */
+    void drainTimerCommands();
+
+    /**
+     * @brief 回收定时任务节点，递增代数使旧句柄失效
+     * @param node 定时任务节点
+     */
+    void recycleTimerNode(TimerNode *node);
+
+    /**
+     * @brief 时间轮到期回调
+     */
+    static void onTimerNodeExpired(CUVTimingWheel::Timer *timer);
+
+    /**
+     * @brief 执行一批已出队的任务，开启指标采集时记录排队和执行时间
+     * @param batch 任务缓冲区
+     * @param count 任务数
+     */
+    void runTasks(CUVTask *batch, size_t count);
+
+    /**
+     * @brief 开启指标采集时为任务记录入队时间
+     * @param task 任务对象
+     */
+    void stampTask(CUVTask &task);
+
+    /**
+     * @brief 延迟探测定时器回调，记录循环延迟并采样libuv指标
+     */
+    static void onLagProbe(uv_timer_t *handle);
+
+    /**
+     * @brief 循环末尾的check回调，执行全部已登记的回调节点
+     */
+    static void onFlushCheck(uv_check_t *handle);
+
+    /**
+     * @brief 忙轮询模式的运行循环，取代uv_run(UV_RUN_DEFAULT)
+     */
+    void runBusyPoll();
+
+    /**
+     * @brief 排空关闭的进度检查定时器回调，排空完成或超过截止时间时结束关闭
+     */
+    static void onDrainProbe(uv_timer_t *handle);
+
+    /**
+     * @brief 统计libuv写队列中尚未写出的字节数
+     * @return 全部未关闭流句柄的写队列字节数之和
+     */
+    size_t pendingWriteBytes() const;
+
+    /**
+     * @brief 丢弃剩余任务，填写关闭报告并停止libuv循环
+     */
+    void finishShutdown();
+
+private:
+    Config m_config;                 // 事件循环配置
+    std::string m_threadConfigError; // 应用线程配置时的错误信息，初始化完成后只读
+    uv_loop_t *m_loop;               // libuv事件循环指针
+    std::thread *m_workerThread;     // 工作线程指针
+    std::atomic<bool> m_isStopping;  // 停止标志
+
+    // 排空关闭
+    std::atomic<bool> m_isDraining;         // 是否处于排空阶段
+    std::atomic<uint64_t> m_drainTimeoutMs; // 排空的最长时间，0表示直接丢弃剩余任务
+    uint64_t m_drainDeadline;               // 排空截止时间（uv_hrtime），0表示未在排空
+    uint64_t m_drainStartTime;              // 排空开始时间（uv_hrtime），仅循环线程访问
+    uint64_t m_drainStartExecuted;          // 排空开始时已执行的任务数，仅循环线程访问
+    ShutdownReport m_shutdownReport;        // 关闭报告，工作线程退出后读取
+    bool m_loopStopped;                     // 是否已停止libuv循环，仅循环线程访问
+
     // 线程同步机制
     std::condition_variable m_condition;
     std::mutex m_mutex;
     bool m_loopInitialized;
+    bool m_initFinished; // 工作线程初始化流程是否结束（无论成功与否）
+
+    std::atomic<size_t> m_connectionCount; // 挂载的连接数
 
     // 异步通信句柄
-    uv_async_t m_asyncWork; // 异步任务触发句柄
-    uv_async_t m_asyncExit; // 异步退出句柄
+    uv_async_t m_asyncWork;  // 异步任务触发句柄
+    uv_async_t m_asyncExit;  // 异步退出句柄
+    uv_timer_t m_lagTimer;   // 延迟探测定时器
+    uv_timer_t m_drainTimer; // 排空关闭的进度检查定时器
+
+    CUVTimingWheel m_timingWheel;                // 共享时间轮
+    std::shared_ptr<CUVBufferPool> m_bufferPool; // 读缓冲池
+
+    // 循环末尾的回调节点，仅循环线程访问
+    uv_check_t m_flushCheck;                 // 执行回调节点的check句柄，有节点登记时才启动
+    std::vector<FlushHook *> m_flushHooks;   // 已登记的回调节点
+    std::vector<FlushHook *> m_runningHooks; // 正在执行的一批回调节点，被取消的节点置为nullptr
+
+    // 定时任务
+    using TimerCommand = std::pair<TimerNode *, uint64_t>;     // 定时任务命令（节点，代数）
+    moodycamel::ConcurrentQueue<TimerCommand> m_timerCommands; // 定时任务命令队列
+    moodycamel::ConcurrentQueue<TimerNode *> m_freeTimerNodes; // 空闲的定时任务节点
+    std::vector<TimerNode *> m_timerNodes;                     // 全部定时任务节点，析构时释放
+    std::mutex m_timerNodesMutex;                              // 保护m_timerNodes
 
     // 任务队列（用于处理异步任务）
-    moodycamel::ConcurrentQueue<std::function<void()>> m_taskQueue;
+    moodycamel::ConcurrentQueue<CUVTask> m_taskQueue;     // 普通任务队列
+    moodycamel::ConcurrentQueue<CUVTask> m_highTaskQueue; // 高优先级任务队列
+    std::atomic<bool> m_wakePending; // 是否已有未处理的唤醒
+    std::atomic<bool> m_busyPolling; // 循环线程是否正在自旋，自旋期间生产者不发送唤醒
+    std::thread::id m_loopThreadId;  // 事件循环线程ID
+
+    // 队列容量控制
+    std::atomic<size_t> m_queueCapacity;               // 队列容量，0表示不限制
+    std::atomic<OverflowPolicy> m_overflowPolicy;      // 溢出策略
+    std::atomic<size_t> m_queueDepth;                  // 当前队列深度
+    std::atomic<size_t> m_queueHighWaterMark;          // 队列深度高水位
+    std::atomic<size_t> m_blockedProducers;            // 被阻塞的生产者数量
+    moodycamel::LightweightSemaphore m_spaceAvailable; // 队列空位通知
+
+    // 排空预算
+    std::atomic<size_t> m_drainTaskBudget;     // 每次排空的任务数预算
+    std::atomic<uint64_t> m_drainTimeBudgetUs; // 每次排空的耗时预算，单位微秒
+
+    // 统计计数
+    std::atomic<uint64_t> m_executedTaskCount;   // 已执行的任务数
+    std::atomic<uint64_t> m_wakeupCount;         // 唤醒次数
+    std::atomic<uint64_t> m_drainCount;          // 排空次数
+    std::atomic<uint64_t> m_rejectedTaskCount;   // 被拒绝的任务数
+    std::atomic<uint64_t> m_droppedTaskCount;    // 被丢弃的任务数
+    std::atomic<uint64_t> m_truncatedDrainCount; // 提前结束的排空次数
+    std::atomic<uint64_t> m_busyPollSpinCount;   // 忙轮询自旋次数
+    std::atomic<uint64_t> m_busyPollBlockCount;  // 忙轮询退回阻塞等待的次数
+
+    // 运行指标
+    std::atomic<bool> m_metricsEnabled;       // 是否开启指标采集
+    CLatencyHistogram m_loopLagHistogram;     // 循环延迟直方图
+    CLatencyHistogram m_queueWaitHistogram;   // 排队时间直方图
+    CLatencyHistogram m_taskExecHistogram;    // 执行时间直方图
+    uint64_t m_lagProbeExpected;              // 延迟探测的下一次预期触发时间，仅循环线程访问
+    std::atomic<uint64_t> m_sampledLoopCount; // 采样的循环迭代次数
+    std::atomic<uint64_t> m_sampledEvents;    // 采样的事件数
+    std::atomic<uint64_t> m_sampledWaiting;   // 采样的等待事件数
+    std::atomic<uint64_t> m_sampledIdleTime;  // 采样的累计空闲时间
+    std::atomic<uint64_t> m_sampledTime;      // 采样时刻
+    std::mutex m_metricsMutex;                // 保护上一次采集的数据
+    uint64_t m_lastScrapeTime;                // 上一次采集时的采样时刻
+    uint64_t m_lastScrapeIdleTime;            // 上一次采集时的累计空闲时间
 };
 
 } // namespace Network
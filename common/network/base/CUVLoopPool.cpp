@@ -0,0 +1,121 @@
+#include "CUVLoopPool.h"
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace Common::Network;
+
+std::atomic<size_t> CUVLoopPool::s_defaultLoopCount(0);
+
+// 全局默认循环池的循环配置
+static CUVLoop::Config s_defaultLoopConfig;
+static std::mutex s_defaultLoopConfigMutex;
+
+// 构造函数
+CUVLoopPool::CUVLoopPool(size_t loopCount)
+    : CUVLoopPool(loopCount, CUVLoop::Config())
+{}
+
+// 按配置构造
+CUVLoopPool::CUVLoopPool(size_t loopCount, const CUVLoop::Config &config)
+    : m_nextIndex(0)
+{
+    if (loopCount == 0) {
+        loopCount = config.cpuAffinity.size();
+    }
+    if (loopCount == 0) {
+        loopCount = std::thread::hardware_concurrency();
+    }
+    if (loopCount == 0) {
+        loopCount = 1;
+    }
+
+    m_loops.reserve(loopCount);
+    for (size_t i = 0; i < loopCount; ++i) {
+        CUVLoop::Config loopConfig = config;
+        if (!config.threadName.empty()) {
+            loopConfig.threadName += "-" + std::to_string(i);
+        }
+        if (!config.cpuAffinity.empty()) {
+            loopConfig.cpuAffinity = {config.cpuAffinity[i % config.cpuAffinity.size()]};
+        }
+        m_loops.push_back(new CUVLoop(loopConfig));
+    }
+}
+
+// 析构函数
+CUVLoopPool::~CUVLoopPool()
+{
+    for (CUVLoop *loop : m_loops) {
+        delete loop;
+    }
+    m_loops.clear();
+}
+
+// 获取全局默认的事件循环池
+CUVLoopPool *CUVLoopPool::getInstance()
+{
+    static CUVLoopPool instance(s_defaultLoopCount.load(), [] {
+        std::lock_guard<std::mutex> lock(s_defaultLoopConfigMutex);
+        return s_defaultLoopConfig;
+    }());
+    return &instance;
+}
+
+// 设置全局默认循环池的循环数量
+void CUVLoopPool::setDefaultLoopCount(size_t loopCount)
+{
+    s_defaultLoopCount.store(loopCount);
+}
+
+// 设置全局默认循环池的循环配置
+void CUVLoopPool::setDefaultLoopConfig(const CUVLoop::Config &config)
+{
+    std::lock_guard<std::mutex> lock(s_defaultLoopConfigMutex);
+    s_defaultLoopConfig = config;
+}
+
+// 获取循环数量
+size_t CUVLoopPool::size() const
+{
+    return m_loops.size();
+}
+
+// 按索引获取事件循环
+CUVLoop *CUVLoopPool::getLoop(size_t index) const
+{
+    return m_loops[index % m_loops.size()];
+}
+
+// 轮询选择
+CUVLoop *CUVLoopPool::nextLoop()
+{
+    return getLoop(m_nextIndex.fetch_add(1, std::memory_order_relaxed));
+}
+
+// 最小负载选择
+CUVLoop *CUVLoopPool::leastLoadedLoop() const
+{
+    CUVLoop *selected = m_loops.front();
+    size_t minLoad = selected->getLoad();
+    for (size_t i = 1; i < m_loops.size() && minLoad > 0; ++i) {
+        size_t load = m_loops[i]->getLoad();
+        if (load < minLoad) {
+            minLoad = load;
+            selected = m_loops[i];
+        }
+    }
+    return selected;
+}
+
+// 键哈希选择
+CUVLoop *CUVLoopPool::loopForKey(const std::string &key) const
+{
+    return loopForHash(std::hash<std::string>{}(key));
+}
+
+// 哈希值选择
+CUVLoop *CUVLoopPool::loopForHash(uint64_t hash) const
+{
+    return getLoop(static_cast<size_t>(hash % m_loops.size()));
+}
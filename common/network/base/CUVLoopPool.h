@@ -0,0 +1,111 @@
+#ifndef CUVLOOPPOOL_H
+#define CUVLOOPPOOL_H
+
+#include "CUVLoop.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 事件循环池，每个CPU核心一个libuv事件循环
+ * @details 每个CUVLoop拥有独立的工作线程、任务队列和异步句柄，
+ *          连接按轮询、最小负载或键哈希的方式分配到不同的循环上
+ */
+class CUVLoopPool
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param loopCount 事件循环数量，0表示使用硬件并发数
+     */
+    explicit CUVLoopPool(size_t loopCount = 0);
+
+    /**
+     * @brief 按配置构造
+     * @details 每个循环使用同一份配置，但线程名追加"-索引"后缀；
+     *          cpuAffinity非空时第i个循环只绑定到cpuAffinity[i % cpuAffinity.size()]，
+     *          即每个循环独占一个核心
+     * @param loopCount 事件循环数量，0表示使用cpuAffinity中的CPU数量，再为0则使用硬件并发数
+     * @param config 事件循环配置
+     */
+    CUVLoopPool(size_t loopCount, const CUVLoop::Config &config);
+    ~CUVLoopPool();
+
+    // 禁止拷贝构造和赋值操作
+    CUVLoopPool(const CUVLoopPool &) = delete;
+    CUVLoopPool &operator=(const CUVLoopPool &) = delete;
+
+    /**
+     * @brief 获取全局默认的事件循环池
+     * @return CUVLoopPool实例指针
+     */
+    static CUVLoopPool *getInstance();
+
+    /**
+     * @brief 设置全局默认循环池的循环数量
+     * @details 必须在第一次调用getInstance()之前设置，之后的设置无效
+     * @param loopCount 事件循环数量，0表示使用硬件并发数
+     */
+    static void setDefaultLoopCount(size_t loopCount);
+
+    /**
+     * @brief 设置全局默认循环池的循环配置
+     * @details 必须在第一次调用getInstance()之前设置，之后的设置无效
+     * @param config 事件循环配置，规则同CUVLoopPool(size_t, const CUVLoop::Config &)
+     */
+    static void setDefaultLoopConfig(const CUVLoop::Config &config);
+
+    /**
+     * @brief 获取循环数量
+     * @return 循环数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 按索引获取事件循环
+     * @param index 循环索引（超出范围时取模）
+     * @return CUVLoop实例指针
+     */
+    CUVLoop *getLoop(size_t index) const;
+
+    /**
+     * @brief 以轮询方式选择下一个事件循环
+     * @return CUVLoop实例指针
+     */
+    CUVLoop *nextLoop();
+
+    /**
+     * @brief 选择当前负载最小的事件循环
+     * @return CUVLoop实例指针
+     */
+    CUVLoop *leastLoadedLoop() const;
+
+    /**
+     * @brief 根据键的哈希选择事件循环，相同的键总是落在同一个循环上
+     * @param key 键
+     * @return CUVLoop实例指针
+     */
+    CUVLoop *loopForKey(const std::string &key) const;
+
+    /**
+     * @brief 根据哈希值选择事件循环
+     * @param hash 哈希值
+     * @return CUVLoop实例指针
+     */
+    CUVLoop *loopForHash(uint64_t hash) const;
+
+private:
+    std::vector<CUVLoop *> m_loops;  // 事件循环列表
+    std::atomic<size_t> m_nextIndex; // 轮询索引
+
+    static std::atomic<size_t> s_defaultLoopCount; // 默认循环数量
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVLOOPPOOL_H
@@ -0,0 +1,182 @@
+#ifndef CUVSLOTMAP_H
+#define CUVSLOTMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 带代数的稠密槽位表，用整数键O(1)查找，用于连接表等需要检测过期键的场景
+ * @details 键由槽位索引和代数组成，共48位：低24位为槽位索引，高24位为代数，0永远不是有效键；
+ *          元素被删除时槽位代数加一，之前发出的键随之失效，槽位被复用后旧键也不会误中新元素；
+ *          空闲槽位按先进先出复用，尽量推迟同一槽位的代数回绕；
+ *          元素紧凑地存放在连续数组中，删除时与末尾元素交换，遍历只访问有效元素；
+ *          不是线程安全的
+ */
+template<typename T>
+class CUVSlotMap
+{
+public:
+    using Key = uint64_t;
+
+    static constexpr uint32_t kIndexBits = 24;                                       // 槽位索引位数
+    static constexpr uint32_t kGenerationBits = 24;                                  // 代数位数
+    static constexpr Key kKeyMask = (Key(1) << (kIndexBits + kGenerationBits)) - 1; // 键的有效位
+    static constexpr size_t kMaxSize = size_t(1) << kIndexBits;                      // 最大元素数
+
+    CUVSlotMap()
+        : m_freeHead(kNone)
+        , m_freeTail(kNone)
+    {}
+
+    /**
+     * @brief 插入元素
+     * @param value 元素
+     * @return 元素的键，槽位已用尽时返回0
+     */
+    Key insert(T value)
+    {
+        uint32_t index;
+        if (m_freeHead != kNone) {
+            index = m_freeHead;
+            m_freeHead = m_slots[index].link;
+            if (m_freeHead == kNone) {
+                m_freeTail = kNone;
+            }
+        } else if (m_slots.size() < kMaxSize) {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{1, 0});
+        } else {
+            return 0;
+        }
+
+        Slot &slot = m_slots[index];
+        slot.link = static_cast<uint32_t>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_valueSlots.push_back(index);
+        return (static_cast<Key>(slot.generation) << kIndexBits) | index;
+    }
+
+    /**
+     * @brief 查找元素
+     * @param key 元素的键
+     * @return 元素指针，键无效或已过期时返回nullptr
+     */
+    T *find(Key key)
+    {
+        const Slot *slot = slotOf(key);
+        return slot ? &m_values[slot->link] : nullptr;
+    }
+
+    const T *find(Key key) const
+    {
+        const Slot *slot = slotOf(key);
+        return slot ? &m_values[slot->link] : nullptr;
+    }
+
+    /**
+     * @brief 删除元素
+     * @param key 元素的键
+     * @return 是否删除了元素，键无效或已过期时返回false
+     */
+    bool erase(Key key)
+    {
+        if (!slotOf(key)) {
+            return false;
+        }
+
+        uint32_t index = static_cast<uint32_t>(key & kIndexMask);
+        Slot &slot = m_slots[index];
+
+        // 末尾元素移到被删除元素的位置
+        uint32_t position = slot.link;
+        uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (position != last) {
+            m_values[position] = std::move(m_values[last]);
+            m_valueSlots[position] = m_valueSlots[last];
+            m_slots[m_valueSlots[position]].link = position;
+        }
+        m_values.pop_back();
+        m_valueSlots.pop_back();
+
+        // 代数加一使旧键失效，回绕时跳过0
+        slot.generation = (slot.generation + 1) & kGenerationMask;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+
+        // 放到空闲链表末尾
+        slot.link = kNone;
+        if (m_freeTail != kNone) {
+            m_slots[m_freeTail].link = index;
+        } else {
+            m_freeHead = index;
+        }
+        m_freeTail = index;
+        return true;
+    }
+
+    /**
+     * @brief 删除全部元素，已发出的键全部失效
+     */
+    void clear()
+    {
+        while (!m_values.empty()) {
+            uint32_t index = m_valueSlots.back();
+            erase((static_cast<Key>(m_slots[index].generation) << kIndexBits) | index);
+        }
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    // 按存放顺序遍历元素，遍历期间不能插入或删除
+    typename std::vector<T>::iterator begin() { return m_values.begin(); }
+    typename std::vector<T>::iterator end() { return m_values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_values.end(); }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr Key kIndexMask = (Key(1) << kIndexBits) - 1;
+    static constexpr uint32_t kGenerationMask = (uint32_t(1) << kGenerationBits) - 1;
+
+    // 槽位：使用中时link为元素在数组中的位置，空闲时为空闲链表中下一个槽位
+    struct Slot
+    {
+        uint32_t generation; // 当前代数，空闲槽位为下一次发出的代数
+        uint32_t link;       // 元素位置或下一个空闲槽位
+    };
+
+    // 键有效时返回对应的槽位
+    const Slot *slotOf(Key key) const
+    {
+        Key index = key & kIndexMask;
+        uint32_t generation = static_cast<uint32_t>((key >> kIndexBits) & kGenerationMask);
+        if (key > kKeyMask || index >= m_slots.size()) {
+            return nullptr;
+        }
+        const Slot &slot = m_slots[index];
+        if (slot.generation != generation || slot.link >= m_values.size()
+            || m_valueSlots[slot.link] != index) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+private:
+    std::vector<Slot> m_slots;          // 槽位
+    std::vector<T> m_values;            // 紧凑存放的元素
+    std::vector<uint32_t> m_valueSlots; // 每个元素所在的槽位
+    uint32_t m_freeHead;                // 空闲链表头
+    uint32_t m_freeTail;                // 空闲链表尾
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVSLOTMAP_H
@@ -0,0 +1,188 @@
+#ifndef CUVTASK_H
+#define CUVTASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 事件循环任务类型，只能移动的void()可调用对象
+ * @details 与std::function不同，捕获内容不超过kInlineSize字节的可调用对象
+ *          直接存放在内部缓冲区中，投递任务时不需要堆分配；
+ *          超出大小的可调用对象才会退化为堆分配
+ */
+class CUVTask
+{
+public:
+    static constexpr size_t kInlineSize = 112; // 内联存储大小，单位字节
+
+    CUVTask() noexcept
+        : m_ops(nullptr)
+        , m_enqueueTime(0)
+    {}
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+    CUVTask(Func &&func)
+        : m_ops(nullptr)
+        , m_enqueueTime(0)
+    {
+        using Callable = std::decay_t<Func>;
+        // 空的std::function或空函数指针不持有可调用对象
+        if constexpr (std::is_constructible<bool, const Callable &>::value) {
+            if (!static_cast<bool>(func)) {
+                return;
+            }
+        }
+        if constexpr (isInline<Callable>()) {
+            new (&m_storage) Callable(std::forward<Func>(func));
+            m_ops = &inlineOps<Callable>;
+        } else {
+            *reinterpret_cast<Callable **>(&m_storage) = new Callable(std::forward<Func>(func));
+            m_ops = &heapOps<Callable>;
+        }
+    }
+
+    CUVTask(CUVTask &&other) noexcept
+        : m_ops(other.m_ops)
+        , m_enqueueTime(other.m_enqueueTime)
+    {
+        if (m_ops) {
+            m_ops->move(&m_storage, &other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    CUVTask &operator=(CUVTask &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            if (other.m_ops) {
+                other.m_ops->move(&m_storage, &other.m_storage);
+                m_ops = other.m_ops;
+                other.m_ops = nullptr;
+            }
+            m_enqueueTime = other.m_enqueueTime;
+        }
+        return *this;
+    }
+
+    ~CUVTask() { reset(); }
+
+    // 禁止拷贝
+    CUVTask(const CUVTask &) = delete;
+    CUVTask &operator=(const CUVTask &) = delete;
+
+    /**
+     * @brief 是否持有可调用对象
+     */
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    /**
+     * @brief 执行任务，不持有可调用对象时不做任何处理
+     */
+    void operator()()
+    {
+        if (m_ops) {
+            m_ops->invoke(&m_storage);
+        }
+    }
+
+    /**
+     * @brief 销毁持有的可调用对象
+     */
+    void reset() noexcept
+    {
+        if (m_ops) {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    /**
+     * @brief 记录入队时间，用于统计排队等待时间
+     * @param time 入队时间，单位纳秒，0表示未记录
+     */
+    void setEnqueueTime(uint64_t time) noexcept { m_enqueueTime = time; }
+
+    /**
+     * @brief 获取入队时间
+     * @return 入队时间，单位纳秒，0表示未记录
+     */
+    uint64_t enqueueTime() const noexcept { return m_enqueueTime; }
+
+private:
+    // 类型擦除操作表
+    struct Ops
+    {
+        void (*invoke)(void *storage);
+        void (*move)(void *dst, void *src) noexcept;
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template<typename Callable>
+    static constexpr bool isInline()
+    {
+        return sizeof(Callable) <= kInlineSize && alignof(Callable) <= alignof(std::max_align_t)
+               && std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    // 内联存储的操作
+    template<typename Callable>
+    static void inlineInvoke(void *storage)
+    {
+        (*static_cast<Callable *>(storage))();
+    }
+    template<typename Callable>
+    static void inlineMove(void *dst, void *src) noexcept
+    {
+        new (dst) Callable(std::move(*static_cast<Callable *>(src)));
+        static_cast<Callable *>(src)->~Callable();
+    }
+    template<typename Callable>
+    static void inlineDestroy(void *storage) noexcept
+    {
+        static_cast<Callable *>(storage)->~Callable();
+    }
+
+    // 堆存储的操作
+    template<typename Callable>
+    static void heapInvoke(void *storage)
+    {
+        (**static_cast<Callable **>(storage))();
+    }
+    template<typename Callable>
+    static void heapMove(void *dst, void *src) noexcept
+    {
+        *static_cast<Callable **>(dst) = *static_cast<Callable **>(src);
+    }
+    template<typename Callable>
+    static void heapDestroy(void *storage) noexcept
+    {
+        delete *static_cast<Callable **>(storage);
+    }
+
+    template<typename Callable>
+    static constexpr Ops inlineOps = {&inlineInvoke<Callable>,
+                                      &inlineMove<Callable>,
+                                      &inlineDestroy<Callable>};
+    template<typename Callable>
+    static constexpr Ops heapOps = {&heapInvoke<Callable>,
+                                    &heapMove<Callable>,
+                                    &heapDestroy<Callable>};
+
+private:
+    alignas(std::max_align_t) unsigned char m_storage[kInlineSize]; // 内联存储
+    const Ops *m_ops;                                               // 操作表
+    uint64_t m_enqueueTime;                                         // 入队时间，单位纳秒，0表示未记录
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVTASK_H
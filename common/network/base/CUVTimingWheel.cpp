@@ -0,0 +1,260 @@
+#include "CUVTimingWheel.h"
+
+using namespace Common::Network;
+
+// 构造函数
+CUVTimingWheel::CUVTimingWheel()
+    : m_loop(nullptr)
+    , m_handle(nullptr)
+    , m_currentTick(0)
+    , m_nextWake(0)
+    , m_count(0)
+{
+    // 槽的链表头为哨兵节点，空链表时指向自身
+    for (Timer &head : m_root) {
+        head.prev = head.next = &head;
+    }
+    for (auto &level : m_levels) {
+        for (Timer &head : level) {
+            head.prev = head.next = &head;
+        }
+    }
+}
+
+// 初始化驱动定时器
+int CUVTimingWheel::init(uv_loop_t *loop)
+{
+    m_handle = new uv_timer_t;
+    int result = uv_timer_init(loop, m_handle);
+    if (result != 0) {
+        delete m_handle;
+        m_handle = nullptr;
+        return result;
+    }
+
+    // 时间轮定时器不阻止事件循环退出
+    m_handle->data = this;
+    uv_unref(reinterpret_cast<uv_handle_t *>(m_handle));
+
+    m_loop = loop;
+    m_currentTick = uv_now(loop);
+    return 0;
+}
+
+// 关闭驱动定时器
+void CUVTimingWheel::close()
+{
+    if (m_handle) {
+        uv_timer_stop(m_handle);
+        uv_close(reinterpret_cast<uv_handle_t *>(m_handle),
+                 [](uv_handle_t *handle) { delete reinterpret_cast<uv_timer_t *>(handle); });
+        m_handle = nullptr;
+    }
+    m_nextWake = 0;
+}
+
+// 调度定时器
+void CUVTimingWheel::schedule(Timer *timer, uint64_t delayMs)
+{
+    if (!m_handle) {
+        return;
+    }
+
+    // 时间轮为空时驱动定时器已停止，直接对齐到当前时刻，避免之后逐毫秒追赶
+    uint64_t now = uv_now(m_loop);
+    if (m_count == 0 && m_currentTick < now) {
+        m_currentTick = now;
+    }
+
+    uint64_t expire = now + delayMs;
+    if (expire <= m_currentTick) {
+        expire = m_currentTick + 1;
+    }
+
+    if (isScheduled(timer)) {
+        // 延后时只记录新的到期时间，到达原槽位时再重新插入
+        if (expire >= timer->expire) {
+            timer->expire = expire;
+            return;
+        }
+        unlink(timer);
+    } else {
+        ++m_count;
+    }
+
+    timer->expire = expire;
+    insert(timer);
+
+    // 新定时器早于驱动定时器的下一次触发时才需要重新设置
+    if (m_nextWake == 0 || expire < m_nextWake) {
+        rearm();
+    }
+}
+
+// 取消定时器
+void CUVTimingWheel::cancel(Timer *timer)
+{
+    if (isScheduled(timer)) {
+        unlink(timer);
+        --m_count;
+    }
+}
+
+// 驱动定时器回调
+void CUVTimingWheel::onTick(uv_timer_t *handle)
+{
+    CUVTimingWheel *wheel = static_cast<CUVTimingWheel *>(handle->data);
+    uint64_t now = uv_now(wheel->m_loop);
+
+    wheel->m_nextWake = 0;
+    while (wheel->m_currentTick < now && wheel->m_handle) {
+        // 没有定时器时直接跳到当前时刻
+        if (wheel->m_count == 0) {
+            wheel->m_currentTick = now;
+            break;
+        }
+
+        ++wheel->m_currentTick;
+        size_t index = static_cast<size_t>(wheel->m_currentTick & (kRootSize - 1));
+        if (index == 0) {
+            wheel->cascade();
+        }
+        wheel->runSlot(index);
+    }
+
+    if (wheel->m_handle) {
+        wheel->rearm();
+    }
+}
+
+// 把定时器链接到对应层的槽中
+void CUVTimingWheel::insert(Timer *timer)
+{
+    uint64_t expire = timer->expire;
+    uint64_t delta = expire - m_currentTick;
+
+    // 超出覆盖范围的定时器先放在最高层，重新分层时再按剩余时间处理
+    if (delta >= kMaxSpan) {
+        expire = m_currentTick + kMaxSpan - 1;
+        delta = kMaxSpan - 1;
+    }
+
+    if (delta < kRootSize) {
+        linkTail(&m_root[expire & (kRootSize - 1)], timer);
+        return;
+    }
+
+    for (size_t level = 0; level < kLevelCount - 1; ++level) {
+        unsigned shift = kRootBits + kLevelBits * static_cast<unsigned>(level);
+        if (delta < (uint64_t(1) << (shift + kLevelBits))) {
+            linkTail(&m_levels[level][(expire >> shift) & (kLevelSize - 1)], timer);
+            return;
+        }
+    }
+}
+
+// 将高层槽中的定时器重新分配到低层
+void CUVTimingWheel::cascade()
+{
+    for (size_t level = 0; level < kLevelCount - 1; ++level) {
+        unsigned shift = kRootBits + kLevelBits * static_cast<unsigned>(level);
+        size_t index = static_cast<size_t>((m_currentTick >> shift) & (kLevelSize - 1));
+
+        Timer *head = &m_levels[level][index];
+        while (head->next != head) {
+            Timer *timer = head->next;
+            unlink(timer);
+            insert(timer);
+        }
+
+        // 该层未回绕时更高层不需要处理
+        if (index != 0) {
+            break;
+        }
+    }
+}
+
+// 处理第0层中当前时刻的槽
+void CUVTimingWheel::runSlot(size_t index)
+{
+    Timer *head = &m_root[index];
+    if (head->next == head) {
+        return;
+    }
+
+    // 先把整个槽移到局部链表，回调中调度或取消其他定时器不影响遍历
+    Timer pending;
+    pending.prev = head->prev;
+    pending.next = head->next;
+    pending.prev->next = &pending;
+    pending.next->prev = &pending;
+    head->prev = head->next = head;
+
+    while (pending.next != &pending) {
+        Timer *timer = pending.next;
+        unlink(timer);
+
+        // 被延后的定时器重新插入
+        if (timer->expire > m_currentTick) {
+            insert(timer);
+            continue;
+        }
+
+        --m_count;
+        timer->callback(timer);
+
+        // 回调中可能关闭了时间轮
+        if (!m_handle) {
+            while (pending.next != &pending) {
+                unlink(pending.next);
+            }
+            return;
+        }
+    }
+}
+
+// 重新设置驱动定时器
+void CUVTimingWheel::rearm()
+{
+    if (m_count == 0) {
+        uv_timer_stop(m_handle);
+        m_nextWake = 0;
+        return;
+    }
+
+    // 最近可能到期的时刻：第0层本轮内第一个非空槽，否则为下一次重新分层的时刻
+    uint64_t boundary = (m_currentTick | (kRootSize - 1)) + 1;
+    uint64_t target = boundary;
+    for (uint64_t tick = m_currentTick + 1; tick < boundary; ++tick) {
+        Timer *head = &m_root[tick & (kRootSize - 1)];
+        if (head->next != head) {
+            target = tick;
+            break;
+        }
+    }
+
+    if (m_nextWake == target) {
+        return;
+    }
+    m_nextWake = target;
+
+    uint64_t now = uv_now(m_loop);
+    uv_timer_start(m_handle, onTick, target > now ? target - now : 0, 0);
+}
+
+// 链接到链表尾部
+void CUVTimingWheel::linkTail(Timer *head, Timer *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+// 从链表中移除
+void CUVTimingWheel::unlink(Timer *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = nullptr;
+}
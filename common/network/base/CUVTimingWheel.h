@@ -0,0 +1,136 @@
+#ifndef CUVTIMINGWHEEL_H
+#define CUVTIMINGWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <uv.h>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 分层时间轮，由一个uv_timer_t驱动，用于大量连接的超时管理
+ * @details 精度为1毫秒，第0层256个槽，其余3层各64个槽，可覆盖约18.6小时，
+ *          更远的定时器在到期前会重新分层；
+ *          定时器节点侵入式地链接在槽的双向链表中，调度、重新调度和取消都是O(1)；
+ *          延后已调度的定时器时只更新到期时间，到达原槽位时再重新插入，
+ *          因此每次收到数据时重置空闲超时的开销只有一次赋值；
+ *          所有接口只能在所属事件循环线程中调用
+ */
+class CUVTimingWheel
+{
+public:
+    /**
+     * @brief 时间轮定时器节点，由使用者持有，在被调度期间不能销毁
+     */
+    struct Timer
+    {
+        using Callback = void (*)(Timer *timer); // 到期回调类型
+
+        Callback callback = nullptr; // 到期回调
+        void *data = nullptr;        // 用户数据
+
+    private:
+        friend class CUVTimingWheel;
+
+        Timer *prev = nullptr; // 前一个节点
+        Timer *next = nullptr; // 后一个节点，nullptr表示未被调度
+        uint64_t expire = 0;   // 到期时间，单位毫秒（libuv循环时间）
+    };
+
+    CUVTimingWheel();
+
+    /**
+     * @brief 析构函数，驱动定时器必须已在事件循环关闭前通过close()关闭
+     */
+    ~CUVTimingWheel() = default;
+
+    // 禁止拷贝构造和赋值操作
+    CUVTimingWheel(const CUVTimingWheel &) = delete;
+    CUVTimingWheel &operator=(const CUVTimingWheel &) = delete;
+
+    /**
+     * @brief 在事件循环上初始化驱动定时器
+     * @param loop libuv事件循环
+     * @return 0表示成功，否则为libuv错误码
+     */
+    int init(uv_loop_t *loop);
+
+    /**
+     * @brief 关闭驱动定时器，尚未到期的定时器不再触发
+     */
+    void close();
+
+    /**
+     * @brief 调度定时器，已被调度的定时器会被重新调度
+     * @param timer 定时器节点，callback必须已设置
+     * @param delayMs 延迟，单位毫秒
+     */
+    void schedule(Timer *timer, uint64_t delayMs);
+
+    /**
+     * @brief 取消定时器，未被调度时无操作
+     * @param timer 定时器节点
+     */
+    void cancel(Timer *timer);
+
+    /**
+     * @brief 定时器是否处于被调度状态
+     * @param timer 定时器节点
+     */
+    static bool isScheduled(const Timer *timer) { return timer->next != nullptr; }
+
+    /**
+     * @brief 获取被调度的定时器数量
+     */
+    size_t size() const { return m_count; }
+
+private:
+    static constexpr size_t kLevelCount = 4;                     // 层数
+    static constexpr unsigned kRootBits = 8;                     // 第0层的位数
+    static constexpr unsigned kLevelBits = 6;                    // 其余各层的位数
+    static constexpr size_t kRootSize = size_t(1) << kRootBits;   // 第0层的槽数
+    static constexpr size_t kLevelSize = size_t(1) << kLevelBits; // 其余各层的槽数
+    static constexpr uint64_t kMaxSpan
+        = uint64_t(1) << (kRootBits + kLevelBits * (kLevelCount - 1)); // 可覆盖的时间跨度，单位毫秒
+
+    static void onTick(uv_timer_t *handle);
+
+    /**
+     * @brief 按到期时间把定时器链接到对应层的槽中
+     */
+    void insert(Timer *timer);
+
+    /**
+     * @brief 将高层槽中的定时器重新分配到低层
+     */
+    void cascade();
+
+    /**
+     * @brief 处理第0层中当前时刻的槽
+     */
+    void runSlot(size_t index);
+
+    /**
+     * @brief 按最近可能到期的时刻重新设置驱动定时器
+     */
+    void rearm();
+
+    static void linkTail(Timer *head, Timer *timer);
+    static void unlink(Timer *timer);
+
+private:
+    uv_loop_t *m_loop;      // 所属事件循环
+    uv_timer_t *m_handle;   // 驱动定时器
+    uint64_t m_currentTick; // 已处理到的时刻
+    uint64_t m_nextWake;    // 驱动定时器下一次触发的时刻，0表示未启动
+    size_t m_count;         // 被调度的定时器数量
+
+    Timer m_root[kRootSize];                     // 第0层的槽（链表头）
+    Timer m_levels[kLevelCount - 1][kLevelSize]; // 其余各层的槽（链表头）
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVTIMINGWHEEL_H
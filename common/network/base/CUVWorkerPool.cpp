@@ -0,0 +1,171 @@
+#include "CUVWorkerPool.h"
+
+using namespace Common::Network;
+
+// 构造函数
+CUVWorkerPool::Strand::Strand(CUVWorkerPool *pool)
+    : m_pool(pool)
+    , m_scheduled(false)
+{}
+
+// 向Strand投递任务
+bool CUVWorkerPool::Strand::post(CUVTask &&task)
+{
+    if (m_pool->m_isStopping.load()) {
+        return false;
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_incoming.push_back(std::move(task));
+        if (!m_scheduled) {
+            m_scheduled = true;
+            schedule = true;
+        }
+    }
+
+    // 只有空闲的Strand需要投递到线程池，已调度的Strand会在本批次结束后继续处理；
+    // 线程池在检查之后开始停止时投递被拒绝，恢复为空闲状态，避免之后的投递都以为已调度
+    if (schedule && !m_pool->post([self = shared_from_this()]() { self->run(); })) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scheduled = false;
+        return false;
+    }
+    return true;
+}
+
+// 执行一批任务
+void CUVWorkerPool::Strand::run()
+{
+    m_pool->m_strandRunCount.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.swap(m_incoming);
+    }
+
+    for (CUVTask &task : m_running) {
+        task();
+    }
+    m_pool->m_strandTaskCount.fetch_add(m_running.size(), std::memory_order_relaxed);
+    m_running.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_incoming.empty()) {
+            m_scheduled = false;
+            return;
+        }
+    }
+
+    // 执行期间又有新任务，重新排到线程池队列末尾，让其他Strand有机会执行；
+    // 线程池已开始停止时投递被拒绝，同样恢复为空闲状态，之后的投递由m_isStopping检查拒绝
+    if (!m_pool->post([self = shared_from_this()]() { self->run(); })) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scheduled = false;
+    }
+}
+
+// 构造函数
+CUVWorkerPool::CUVWorkerPool(size_t threadCount)
+    : m_isStopping(false)
+    , m_executedTaskCount(0)
+    , m_strandTaskCount(0)
+    , m_strandRunCount(0)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.push_back(new std::thread(workerThread, this));
+    }
+}
+
+// 析构函数
+CUVWorkerPool::~CUVWorkerPool()
+{
+    m_isStopping = true;
+    m_taskAvailable.signal(
+        static_cast<moodycamel::LightweightSemaphore::ssize_t>(m_threads.size()));
+
+    for (std::thread *thread : m_threads) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+        delete thread;
+    }
+    m_threads.clear();
+
+    // 丢弃未执行的任务，Strand批次任务中持有的Strand引用随之释放
+    CUVTask task;
+    while (m_queue.try_dequeue(task)) {
+        task.reset();
+    }
+}
+
+// 投递不要求顺序的任务
+bool CUVWorkerPool::post(CUVTask &&task)
+{
+    if (m_isStopping.load()) {
+        return false;
+    }
+
+    m_queue.enqueue(std::move(task));
+    m_taskAvailable.signal();
+    return true;
+}
+
+// 创建串行执行器
+std::shared_ptr<CUVWorkerPool::Strand> CUVWorkerPool::createStrand()
+{
+    return std::make_shared<Strand>(this);
+}
+
+// 获取工作线程数
+size_t CUVWorkerPool::size() const
+{
+    return m_threads.size();
+}
+
+// 获取统计信息
+CUVWorkerPool::Stats CUVWorkerPool::getStats() const
+{
+    Stats stats;
+    stats.executedTasks = m_executedTaskCount.load(std::memory_order_relaxed);
+    stats.strandTasks = m_strandTaskCount.load(std::memory_order_relaxed);
+    stats.strandRuns = m_strandRunCount.load(std::memory_order_relaxed);
+    stats.pendingTasks = m_queue.size_approx();
+    return stats;
+}
+
+// 工作线程函数
+void CUVWorkerPool::workerThread(CUVWorkerPool *pool)
+{
+    moodycamel::ConsumerToken token(pool->m_queue);
+    CUVTask task;
+
+    while (true) {
+        // 每个信号量计数对应一个入队的任务，等到计数后任务一定可以取出
+        pool->m_taskAvailable.wait();
+        if (pool->m_isStopping.load()) {
+            break;
+        }
+
+        while (!pool->m_queue.try_dequeue(token, task)) {
+            if (pool->m_isStopping.load()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        task();
+        task.reset();
+        pool->m_executedTaskCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
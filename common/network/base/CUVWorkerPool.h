@@ -0,0 +1,143 @@
+#ifndef CUVWORKERPOOL_H
+#define CUVWORKERPOOL_H
+
+#include "CUVTask.h"
+#include "concurrentqueue.h"
+#include "lightweightsemaphore.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 工作线程池，用于把耗CPU的回调（如JSON解析）从事件循环线程卸载出去
+ * @details 所有工作线程共享一个无锁任务队列，空闲的线程总是取下一个可执行的任务；
+ *          需要保序的任务通过Strand投递：同一个Strand的任务按投递顺序串行执行，
+ *          不同Strand的任务在不同线程上并行执行；
+ *          线程池必须比使用它的Strand、服务器和客户端存活更久，
+ *          析构时等待正在执行的任务结束，丢弃尚未执行的任务
+ */
+class CUVWorkerPool
+{
+public:
+    /**
+     * @brief 串行执行器，通常每个连接一个
+     * @details 同一时刻最多有一个工作线程在执行该Strand的任务；
+     *          每次被调度时执行一批任务后让出线程，避免单个繁忙连接饿死其他连接
+     */
+    class Strand : public std::enable_shared_from_this<Strand>
+    {
+        friend class CUVWorkerPool;
+
+    public:
+        explicit Strand(CUVWorkerPool *pool);
+
+        // 禁止拷贝构造和赋值操作
+        Strand(const Strand &) = delete;
+        Strand &operator=(const Strand &) = delete;
+
+        /**
+         * @brief 投递一个任务，可在任意线程中调用
+         * @param task 任务对象
+         * @return 任务是否被接受，线程池已停止时返回false
+         */
+        bool post(CUVTask &&task);
+
+        template<typename Func,
+                 typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+        bool post(Func &&func)
+        {
+            return post(CUVTask(std::forward<Func>(func)));
+        }
+
+    private:
+        /**
+         * @brief 在工作线程中执行一批任务
+         */
+        void run();
+
+    private:
+        CUVWorkerPool *m_pool;           // 所属线程池
+        std::mutex m_mutex;              // 保护m_incoming和m_scheduled
+        std::vector<CUVTask> m_incoming; // 等待执行的任务
+        std::vector<CUVTask> m_running;  // 正在执行的一批任务，仅由执行该Strand的线程访问
+        bool m_scheduled;                // 是否已投递到线程池或正在执行
+    };
+
+    /**
+     * @brief 线程池统计信息
+     */
+    struct Stats
+    {
+        uint64_t executedTasks; // 线程池队列中已执行的任务数（Strand的一次调度计为一个）
+        uint64_t strandTasks;   // Strand中已执行的任务数
+        uint64_t strandRuns;    // Strand被调度执行的次数
+        size_t pendingTasks;    // 线程池队列中待执行的任务数（近似值）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param threadCount 工作线程数，0表示使用硬件并发数
+     */
+    explicit CUVWorkerPool(size_t threadCount = 0);
+    ~CUVWorkerPool();
+
+    // 禁止拷贝构造和赋值操作
+    CUVWorkerPool(const CUVWorkerPool &) = delete;
+    CUVWorkerPool &operator=(const CUVWorkerPool &) = delete;
+
+    /**
+     * @brief 投递一个不要求顺序的任务
+     * @param task 任务对象
+     * @return 任务是否被接受，线程池已停止时返回false
+     */
+    bool post(CUVTask &&task);
+
+    template<typename Func,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, CUVTask>::value>>
+    bool post(Func &&func)
+    {
+        return post(CUVTask(std::forward<Func>(func)));
+    }
+
+    /**
+     * @brief 创建一个串行执行器
+     * @return Strand实例
+     */
+    std::shared_ptr<Strand> createStrand();
+
+    /**
+     * @brief 获取工作线程数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+private:
+    static void workerThread(CUVWorkerPool *pool);
+
+private:
+    std::vector<std::thread *> m_threads;             // 工作线程
+    moodycamel::ConcurrentQueue<CUVTask> m_queue;     // 共享任务队列
+    moodycamel::LightweightSemaphore m_taskAvailable; // 任务到达通知
+    std::atomic<bool> m_isStopping;                   // 停止标志
+
+    std::atomic<uint64_t> m_executedTaskCount; // 线程池队列中已执行的任务数
+    std::atomic<uint64_t> m_strandTaskCount;   // Strand中已执行的任务数
+    std::atomic<uint64_t> m_strandRunCount;    // Strand调度次数
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUVWORKERPOOL_H
@@ -0,0 +1,342 @@
+#include "CUVCoTcp.h"
+
+#ifdef CUV_HAS_COROUTINES
+
+using namespace Common::Network;
+
+namespace {
+
+// 关闭并释放TCP句柄
+void closeTcpHandle(uv_tcp_t* handle)
+{
+    handle->data = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t*>(handle),
+             [](uv_handle_t* h) { delete reinterpret_cast<uv_tcp_t*>(h); });
+}
+
+// 通过任务投递恢复协程，用于关闭时取消挂起的操作，避免在close()调用中重入
+void postResume(CUVLoop* loop, std::coroutine_handle<> handle)
+{
+    loop->postTask([handle]() { handle.resume(); }, CUVLoop::TaskPriority::HIGH);
+}
+
+} // namespace
+
+// 构造函数
+CUVCoTcpStream::CUVCoTcpStream(CUVLoop* loop)
+    : m_loop(loop)
+    , m_handle(nullptr)
+    , m_pendingRead(nullptr)
+{}
+
+// 析构函数
+CUVCoTcpStream::~CUVCoTcpStream()
+{
+    close();
+}
+
+// 初始化TCP句柄
+int CUVCoTcpStream::open()
+{
+    if (m_handle) {
+        return 0;
+    }
+
+    m_handle = new uv_tcp_t;
+    int result = uv_tcp_init(m_loop->getLoop(), m_handle);
+    if (result != 0) {
+        delete m_handle;
+        m_handle = nullptr;
+        return result;
+    }
+    m_handle->data = this;
+    return 0;
+}
+
+// 关闭连接
+void CUVCoTcpStream::close()
+{
+    if (!m_handle) {
+        return;
+    }
+
+    ReadAwaiter* reader = m_pendingRead;
+    m_pendingRead = nullptr;
+    uv_read_stop(stream());
+    closeTcpHandle(m_handle);
+    m_handle = nullptr;
+
+    if (reader) {
+        reader->m_result = UV_ECANCELED;
+        postResume(m_loop, reader->m_handle);
+    }
+}
+
+bool CUVCoTcpStream::ConnectAwaiter::await_ready()
+{
+    struct sockaddr_in addr;
+    m_result = uv_ip4_addr(m_host.c_str(), m_port, &addr);
+    if (m_result == 0) {
+        m_result = m_stream->open();
+    }
+    if (m_result == 0) {
+        m_req.data = this;
+        m_result = uv_tcp_connect(&m_req,
+                                  m_stream->m_handle,
+                                  reinterpret_cast<const struct sockaddr*>(&addr),
+                                  CUVCoTcpStream::onConnect);
+    }
+
+    // 请求已发出时挂起，否则直接返回错误
+    return m_result != 0;
+}
+
+bool CUVCoTcpStream::ConnectAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    return true;
+}
+
+// 连接回调
+void CUVCoTcpStream::onConnect(uv_connect_t* req, int status)
+{
+    auto awaiter = static_cast<ConnectAwaiter*>(req->data);
+    awaiter->m_result = status;
+
+    // 连接失败的句柄不能再使用，直接关闭；UV_ECANCELED表示流已关闭
+    if (status != 0 && status != UV_ECANCELED) {
+        awaiter->m_stream->close();
+    }
+    awaiter->m_handle.resume();
+}
+
+bool CUVCoTcpStream::ReadAwaiter::await_ready()
+{
+    if (!m_stream->m_handle) {
+        m_result = UV_EBADF;
+        return true;
+    }
+    if (m_length == 0 || m_stream->m_pendingRead) {
+        m_result = m_length == 0 ? 0 : UV_EBUSY;
+        return true;
+    }
+    return false;
+}
+
+bool CUVCoTcpStream::ReadAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_stream->m_pendingRead = this;
+    int result = uv_read_start(m_stream->stream(), CUVCoTcpStream::onAlloc, CUVCoTcpStream::onRead);
+    if (result != 0) {
+        m_stream->m_pendingRead = nullptr;
+        m_result = result;
+        return false;
+    }
+    return true;
+}
+
+// 分配缓冲区：直接使用挂起读取者的缓冲区剩余部分，数据不经过中间拷贝
+void CUVCoTcpStream::onAlloc(uv_handle_t* handle, size_t, uv_buf_t* buf)
+{
+    auto self = static_cast<CUVCoTcpStream*>(handle->data);
+    ReadAwaiter* reader = self ? self->m_pendingRead : nullptr;
+    if (!reader) {
+        buf->base = nullptr;
+        buf->len = 0;
+        return;
+    }
+    buf->base = reader->m_buffer + reader->m_received;
+    buf->len = (decltype(uv_buf_t::len)) (reader->m_length - reader->m_received);
+}
+
+// 读取回调
+void CUVCoTcpStream::onRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t*)
+{
+    auto self = static_cast<CUVCoTcpStream*>(stream->data);
+    ReadAwaiter* reader = self ? self->m_pendingRead : nullptr;
+    if (!reader || nread == 0) {
+        return;
+    }
+
+    if (nread > 0) {
+        reader->m_received += static_cast<size_t>(nread);
+        if (reader->m_exact && reader->m_received < reader->m_length) {
+            return;
+        }
+        reader->m_result = static_cast<ssize_t>(reader->m_received);
+    } else {
+        reader->m_result = nread;
+    }
+
+    // 停止读取后再恢复，协程中可以立即发起下一次读取或关闭流
+    uv_read_stop(stream);
+    self->m_pendingRead = nullptr;
+    reader->m_handle.resume();
+}
+
+bool CUVCoTcpStream::WriteAwaiter::await_ready()
+{
+    if (!m_stream->m_handle) {
+        m_result = UV_EBADF;
+        return true;
+    }
+    if (m_length == 0) {
+        return true;
+    }
+
+    // 写队列为空时uv_try_write直接写入套接字，全部写完则不挂起
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(m_data), (unsigned int) m_length);
+    int written = uv_try_write(m_stream->stream(), &buf, 1);
+    if (written >= 0 && static_cast<size_t>(written) == m_length) {
+        return true;
+    }
+    if (written < 0 && written != UV_EAGAIN) {
+        m_result = written;
+        return true;
+    }
+    m_written = written > 0 ? static_cast<size_t>(written) : 0;
+    return false;
+}
+
+bool CUVCoTcpStream::WriteAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_req.data = this;
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(m_data + m_written),
+                               (unsigned int) (m_length - m_written));
+    int result = uv_write(&m_req, m_stream->stream(), &buf, 1, CUVCoTcpStream::onWrite);
+    if (result != 0) {
+        m_result = result;
+        return false;
+    }
+    return true;
+}
+
+// 写入回调
+void CUVCoTcpStream::onWrite(uv_write_t* req, int status)
+{
+    auto awaiter = static_cast<WriteAwaiter*>(req->data);
+    awaiter->m_result = status;
+    awaiter->m_handle.resume();
+}
+
+// 构造函数
+CUVCoTcpListener::CUVCoTcpListener(CUVLoop* loop)
+    : m_loop(loop)
+    , m_handle(nullptr)
+    , m_pendingAccept(nullptr)
+    , m_readyCount(0)
+{}
+
+// 析构函数
+CUVCoTcpListener::~CUVCoTcpListener()
+{
+    close();
+}
+
+// 绑定地址并开始监听
+int CUVCoTcpListener::listen(const std::string& host, int port, int backlog)
+{
+    if (m_handle) {
+        return UV_EALREADY;
+    }
+
+    struct sockaddr_in addr;
+    int result = uv_ip4_addr(host.c_str(), port, &addr);
+    if (result != 0) {
+        return result;
+    }
+
+    m_handle = new uv_tcp_t;
+    result = uv_tcp_init(m_loop->getLoop(), m_handle);
+    if (result != 0) {
+        delete m_handle;
+        m_handle = nullptr;
+        return result;
+    }
+    m_handle->data = this;
+
+    result = uv_tcp_bind(m_handle, reinterpret_cast<const struct sockaddr*>(&addr), 0);
+    if (result == 0) {
+        result = uv_listen(reinterpret_cast<uv_stream_t*>(m_handle), backlog, onConnection);
+    }
+    if (result != 0) {
+        closeTcpHandle(m_handle);
+        m_handle = nullptr;
+    }
+    return result;
+}
+
+// 关闭监听器
+void CUVCoTcpListener::close()
+{
+    if (!m_handle) {
+        return;
+    }
+
+    AcceptAwaiter* acceptor = m_pendingAccept;
+    m_pendingAccept = nullptr;
+    closeTcpHandle(m_handle);
+    m_handle = nullptr;
+    m_readyCount = 0;
+
+    if (acceptor) {
+        postResume(m_loop, acceptor->m_handle);
+    }
+}
+
+// 接受一个已到达的连接
+std::unique_ptr<CUVCoTcpStream> CUVCoTcpListener::acceptOne()
+{
+    --m_readyCount;
+
+    auto stream = std::make_unique<CUVCoTcpStream>(m_loop);
+    if (stream->open() != 0
+        || uv_accept(reinterpret_cast<uv_stream_t*>(m_handle), stream->stream()) != 0) {
+        return nullptr;
+    }
+    return stream;
+}
+
+bool CUVCoTcpListener::AcceptAwaiter::await_ready()
+{
+    if (!m_listener->m_handle || m_listener->m_pendingAccept) {
+        return true;
+    }
+    if (m_listener->m_readyCount > 0) {
+        m_stream = m_listener->acceptOne();
+        return true;
+    }
+    return false;
+}
+
+void CUVCoTcpListener::AcceptAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_handle = handle;
+    m_listener->m_pendingAccept = this;
+}
+
+// 新连接回调
+void CUVCoTcpListener::onConnection(uv_stream_t* server, int status)
+{
+    auto self = static_cast<CUVCoTcpListener*>(server->data);
+    if (!self) {
+        return;
+    }
+    if (status == 0) {
+        ++self->m_readyCount;
+    }
+
+    AcceptAwaiter* acceptor = self->m_pendingAccept;
+    if (!acceptor) {
+        return;
+    }
+    self->m_pendingAccept = nullptr;
+    if (status == 0) {
+        acceptor->m_stream = self->acceptOne();
+    }
+    acceptor->m_handle.resume();
+}
+
+#endif // CUV_HAS_COROUTINES
@@ -0,0 +1,264 @@
+#ifndef CUVCOTCP_H
+#define CUVCOTCP_H
+
+#include "common/network/base/CUVCoroutine.h"
+
+#ifdef CUV_HAS_COROUTINES
+
+#include <memory>
+#include <string>
+
+namespace Common {
+namespace Network {
+
+/**
+ * @brief 协程TCP流，CUVTcpClient/CUVTcpServer回调接口之外的可选协程接口
+ * @details 直接封装uv_tcp_t，每个事件不经过std::function；读写请求内嵌在等待者中（即协程帧中），
+ *          读取直接写入调用者的缓冲区，完成时在libuv回调中直接恢复协程，不经过任务队列；
+ *          除构造和析构外，所有接口只能在所属事件循环线程中调用；
+ *          同一时刻最多一个读取和任意多个写入处于挂起状态
+ */
+class CUVCoTcpStream
+{
+    friend class CUVCoTcpListener;
+
+public:
+    /**
+     * @brief 连接等待者，await结果为0或libuv错误码
+     */
+    class ConnectAwaiter
+    {
+        friend class CUVCoTcpStream;
+
+    public:
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        int await_resume() const { return m_result; }
+
+    private:
+        ConnectAwaiter(CUVCoTcpStream* stream, const std::string& host, int port)
+            : m_stream(stream)
+            , m_host(host)
+            , m_port(port)
+            , m_result(0)
+        {}
+
+        CUVCoTcpStream* m_stream;         // 所属流
+        std::string m_host;               // 服务器地址
+        int m_port;                       // 服务器端口
+        int m_result;                     // 连接结果
+        uv_connect_t m_req;               // 连接请求
+        std::coroutine_handle<> m_handle; // 挂起的协程
+    };
+
+    /**
+     * @brief 读取等待者，await结果为读取的字节数或libuv错误码（对端关闭为UV_EOF）
+     */
+    class ReadAwaiter
+    {
+        friend class CUVCoTcpStream;
+
+    public:
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        ssize_t await_resume() const { return m_result; }
+
+    private:
+        ReadAwaiter(CUVCoTcpStream* stream, char* buffer, size_t length, bool exact)
+            : m_stream(stream)
+            , m_buffer(buffer)
+            , m_length(length)
+            , m_received(0)
+            , m_exact(exact)
+            , m_result(0)
+        {}
+
+        CUVCoTcpStream* m_stream;         // 所属流
+        char* m_buffer;                   // 调用者的缓冲区
+        size_t m_length;                  // 缓冲区长度
+        size_t m_received;                // 已读取的字节数
+        bool m_exact;                     // 是否读满缓冲区才完成
+        ssize_t m_result;                 // 读取结果
+        std::coroutine_handle<> m_handle; // 挂起的协程
+    };
+
+    /**
+     * @brief 写入等待者，await结果为0或libuv错误码
+     * @details 先用uv_try_write直接写入，全部写完时不挂起，否则只为剩余部分发起uv_write
+     */
+    class WriteAwaiter
+    {
+        friend class CUVCoTcpStream;
+
+    public:
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> handle);
+        int await_resume() const { return m_result; }
+
+    private:
+        WriteAwaiter(CUVCoTcpStream* stream, const char* data, size_t length)
+            : m_stream(stream)
+            , m_data(data)
+            , m_length(length)
+            , m_written(0)
+            , m_result(0)
+        {}
+
+        CUVCoTcpStream* m_stream;         // 所属流
+        const char* m_data;               // 待写数据，挂起期间由调用者保证有效
+        size_t m_length;                  // 数据长度
+        size_t m_written;                 // uv_try_write已写入的字节数
+        int m_result;                     // 写入结果
+        uv_write_t m_req;                 // 写请求
+        std::coroutine_handle<> m_handle; // 挂起的协程
+    };
+
+    explicit CUVCoTcpStream(CUVLoop* loop);
+    ~CUVCoTcpStream();
+
+    // 禁止拷贝和移动
+    CUVCoTcpStream(const CUVCoTcpStream&) = delete;
+    CUVCoTcpStream& operator=(const CUVCoTcpStream&) = delete;
+
+    /**
+     * @brief 连接服务器
+     * @param host 服务器地址（IPv4）
+     * @param port 服务器端口
+     */
+    ConnectAwaiter connect(const std::string& host, int port)
+    {
+        return ConnectAwaiter(this, host, port);
+    }
+
+    /**
+     * @brief 读取任意数量的数据，有数据到达即完成
+     * @param buffer 缓冲区，挂起期间必须有效
+     * @param length 缓冲区长度
+     */
+    ReadAwaiter readSome(char* buffer, size_t length)
+    {
+        return ReadAwaiter(this, buffer, length, false);
+    }
+
+    /**
+     * @brief 读满缓冲区才完成，中途出错时返回错误码
+     * @param buffer 缓冲区，挂起期间必须有效
+     * @param length 要读取的字节数
+     */
+    ReadAwaiter readExact(char* buffer, size_t length)
+    {
+        return ReadAwaiter(this, buffer, length, true);
+    }
+
+    /**
+     * @brief 写入数据
+     * @param data 数据，挂起期间必须有效
+     * @param length 数据长度
+     */
+    WriteAwaiter write(const char* data, size_t length)
+    {
+        return WriteAwaiter(this, data, length);
+    }
+
+    WriteAwaiter write(const std::string& data) { return WriteAwaiter(this, data.data(), data.size()); }
+
+    /**
+     * @brief 关闭连接
+     * @details 挂起的读取以UV_ECANCELED恢复（通过任务投递，避免在close()调用中重入），
+     *          挂起的连接和写入由libuv以UV_ECANCELED完成
+     */
+    void close();
+
+    bool isOpen() const { return m_handle != nullptr; }
+    CUVLoop* getLoop() const { return m_loop; }
+
+private:
+    int open();
+
+    static void onConnect(uv_connect_t* req, int status);
+    static void onAlloc(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf);
+    static void onRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+    static void onWrite(uv_write_t* req, int status);
+
+    uv_stream_t* stream() const { return reinterpret_cast<uv_stream_t*>(m_handle); }
+
+private:
+    CUVLoop* m_loop;            // 所属事件循环
+    uv_tcp_t* m_handle;         // TCP句柄，关闭后为nullptr
+    ReadAwaiter* m_pendingRead; // 挂起的读取
+};
+
+/**
+ * @brief 协程TCP监听器
+ * @details 接受的连接作为CUVCoTcpStream返回，与监听器运行在同一个事件循环上；
+ *          所有接口只能在所属事件循环线程中调用
+ */
+class CUVCoTcpListener
+{
+public:
+    /**
+     * @brief 接受连接等待者，await结果为新连接，出错或监听器关闭时为nullptr
+     */
+    class AcceptAwaiter
+    {
+        friend class CUVCoTcpListener;
+
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        std::unique_ptr<CUVCoTcpStream> await_resume() { return std::move(m_stream); }
+
+    private:
+        explicit AcceptAwaiter(CUVCoTcpListener* listener)
+            : m_listener(listener)
+        {}
+
+        CUVCoTcpListener* m_listener;             // 所属监听器
+        std::unique_ptr<CUVCoTcpStream> m_stream; // 接受的连接
+        std::coroutine_handle<> m_handle;         // 挂起的协程
+    };
+
+    explicit CUVCoTcpListener(CUVLoop* loop);
+    ~CUVCoTcpListener();
+
+    // 禁止拷贝和移动
+    CUVCoTcpListener(const CUVCoTcpListener&) = delete;
+    CUVCoTcpListener& operator=(const CUVCoTcpListener&) = delete;
+
+    /**
+     * @brief 绑定地址并开始监听
+     * @param host 监听地址（IPv4）
+     * @param port 监听端口
+     * @param backlog 等待队列长度
+     * @return 0表示成功，否则为libuv错误码
+     */
+    int listen(const std::string& host, int port, int backlog = 128);
+
+    /**
+     * @brief 接受一个连接，同一时刻最多一个挂起的接受
+     */
+    AcceptAwaiter accept() { return AcceptAwaiter(this); }
+
+    /**
+     * @brief 关闭监听器，挂起的接受以nullptr恢复
+     */
+    void close();
+
+private:
+    static void onConnection(uv_stream_t* server, int status);
+
+    std::unique_ptr<CUVCoTcpStream> acceptOne();
+
+private:
+    CUVLoop* m_loop;                // 所属事件循环
+    uv_tcp_t* m_handle;             // 监听句柄，关闭后为nullptr
+    AcceptAwaiter* m_pendingAccept; // 挂起的接受
+    size_t m_readyCount;            // 已到达但尚未接受的连接数
+};
+
+} // namespace Network
+} // namespace Common
+
+#endif // CUV_HAS_COROUTINES
+
+#endif // CUVCOTCP_H
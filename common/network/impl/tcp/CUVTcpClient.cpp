@@ -1,8 +1,13 @@
 #include "CUVTcpClient.h"
 #include "common/network/base/CUVLoop.h"
+#include "common/network/base/CUVLoopPool.h"
+#include <cassert>
 #include <cstring>
 // #include <iostream>
+#include <memory>
+#include <utility>
 #include <uv.h>
+#include <vector>
 
 using namespace Common::Network;
 
@@ -22,79 +27,213 @@ struct SendRequest
     CUVTcpClient::SendCallback callback;
 };
 
-// 删除定时器
-void deleteTimer(uv_timer_t* timer)
+// 断开请求数据结构，关闭句柄时替换句柄的data，断开回调不再经过可能已析构的客户端
+struct DisconnectRequest
 {
-    if (timer && !uv_is_closing(reinterpret_cast<uv_handle_t*>(timer))) {
-        uv_timer_stop(timer);
-        uv_close(reinterpret_cast<uv_handle_t*>(timer),
-                 [](uv_handle_t* handle) { delete reinterpret_cast<uv_timer_t*>(handle); });
+    std::shared_ptr<const CUVTcpClient::DisconnectCallback> callback;
+    std::shared_ptr<CUVWorkerPool::Strand> strand;
+};
+
+// 合并写请求数据结构，持有未能直接写完的一批发送请求直到写完成
+struct CUVTcpClient::WriteBatch
+{
+    uv_write_t req;
+    std::vector<SendRequest*> requests;
+};
+
+// 合并发送队列：循环末尾的回调节点，以及本轮循环中排队的发送请求
+struct CUVTcpClient::WriteQueue : CUVLoop::FlushHook
+{
+    std::vector<SendRequest*> requests;
+};
+
+namespace {
+
+// 发送任务持有发送请求时使用的删除器：任务未执行就被销毁时（被拒绝、被DROP_OLDEST策略
+// 挤出队列或随事件循环停止而丢弃）回调尚未取走，报告发送失败，此时回调在销毁任务的线程中调用
+struct DropSendRequest
+{
+    void operator()(SendRequest* request) const
+    {
+        if (request->callback) {
+            request->callback(false, "Send task dropped");
+        }
+        delete request;
+    }
+};
+
+// 取走发送请求的回调并报告失败
+void failSend(SendRequest* request, const std::string& error)
+{
+    if (CUVTcpClient::SendCallback callback = std::exchange(request->callback, nullptr)) {
+        callback(false, error);
     }
 }
 
+// 按发送请求逐条调用用户回调，并释放这些请求
+void finishSends(std::vector<SendRequest*>& requests, bool success, const std::string& error)
+{
+    for (SendRequest* request : requests) {
+        if (request->callback) {
+            request->callback(success, error);
+        }
+        delete request;
+    }
+    requests.clear();
+}
+
+} // namespace
+
+// 发送任务凭据，随发送任务一起移动；任务执行完毕或被销毁时才把待执行的发送任务数减一，
+// 任务未执行就被销毁时先由删除器报告发送失败，计数归零时唤醒等待的客户端析构函数
+class CUVTcpClient::SendTicket
+{
+public:
+    SendTicket(SendRequest* request, CUVTcpClient* client)
+        : m_request(request)
+        , m_client(client)
+    {
+        m_client->m_pendingSends.fetch_add(1);
+    }
+
+    SendTicket(SendTicket&& other) noexcept
+        : m_request(std::move(other.m_request))
+        , m_client(std::exchange(other.m_client, nullptr))
+    {}
+
+    ~SendTicket()
+    {
+        if (m_client) {
+            m_request.reset();
+            if (m_client->m_pendingSends.fetch_sub(1) == 1) {
+                m_client->notifyIdle();
+            }
+        }
+    }
+
+    // 禁止拷贝
+    SendTicket(const SendTicket&) = delete;
+    SendTicket& operator=(const SendTicket&) = delete;
+
+    SendRequest* get() const { return m_request.get(); }
+    SendRequest* release() { return m_request.release(); }
+
+private:
+    std::unique_ptr<SendRequest, DropSendRequest> m_request;
+    CUVTcpClient* m_client;
+};
+
+
 // 构造函数
-CUVTcpClient::CUVTcpClient()
-    : m_loop(CUVLoop::getInstance())
+CUVTcpClient::CUVTcpClient(CUVLoop* loop)
+    : m_loop(loop ? loop : CUVLoopPool::getInstance()->leastLoadedLoop())
     , m_tcpHandle(nullptr)
     , m_state(ConnectState::DISCONNECTED)
     , m_host("")
     , m_port(0)
-    , m_reconnectTimer(nullptr)
+    , m_reconnectTimer(std::make_shared<CUVLoop::TimerHandle>())
     , m_reconnectInterval(1000)
     , m_initialReconnectInterval(1000)
     , m_maxReconnectInterval(30000)
-    , m_receiveTimeoutTimer(nullptr)
+    , m_receiveTimeoutTimer(new CUVTimingWheel::Timer)
     , m_receiveTimeoutInterval(0)
-{}
+    , m_writeQueue(new WriteQueue)
+    , m_pendingSends(0)
+    , m_idleWaiters(0)
+    , m_immediateBytes(0)
+    , m_queuedBytes(0)
+{
+    m_receiveTimeoutTimer->callback = onReceiveTimeout;
+    m_receiveTimeoutTimer->data = this;
+    m_writeQueue->callback = onFlush;
+    m_writeQueue->data = this;
+}
 
 // 析构函数
 CUVTcpClient::~CUVTcpClient()
 {
-    // 清理TCP句柄
-    if (m_tcpHandle) {
-        auto tcpHandle = m_tcpHandle;
-        m_tcpHandle = nullptr;
+    // 前置条件：不在事件循环线程中析构，否则无法等待之前投递的任务执行完毕，
+    // 这些任务和句柄回调会访问已释放的客户端
+    assert(!isLoopValid() || !m_loop->isInLoopThread());
 
-        if (isLoopValid()) {
-            postTask([tcpHandle]() {
-                uv_read_stop(reinterpret_cast<uv_stream_t*>(tcpHandle));
-                uv_close(reinterpret_cast<uv_handle_t*>(tcpHandle),
-                         [](uv_handle_t* handle) { delete reinterpret_cast<uv_tcp_t*>(handle); });
-            });
-        } else {
-            delete tcpHandle;
-        }
+    // 在事件循环线程中关闭连接并取消定时器；事件循环已停止时任务被丢弃，循环不会再访问客户端
+    bool closed = false;
+    if (isLoopValid()) {
+        CUVPromise<void> promise;
+        CUVFuture<void> done = promise.getFuture();
+        postControlTask([this, promise = std::move(promise)]() mutable {
+            closeOnLoop();
+            promise.setValue();
+        });
+        closed = done.wait();
     }
-    // 清理重连定时器
-    if (m_reconnectTimer) {
-        auto reconnectTimer = m_reconnectTimer;
-        m_reconnectTimer = nullptr;
-
-        if (isLoopValid()) {
-            postTask([reconnectTimer]() {
-                deleteTimer(reconnectTimer);
-            });
-        } else {
-            delete reconnectTimer;
+    if (!closed) {
+        finishSends(m_writeQueue->requests, false, "Client destroyed");
+        if (!isLoopValid()) {
+            delete m_tcpHandle;
         }
     }
-    // 清理接收超时定时器
-    if (m_receiveTimeoutTimer) {
-        auto receiveTimeoutTimer = m_receiveTimeoutTimer;
-        m_receiveTimeoutTimer = nullptr;
 
-        if (isLoopValid()) {
-            postTask([receiveTimeoutTimer]() {
-                deleteTimer(receiveTimeoutTimer);
-            });
-        } else {
-            delete receiveTimeoutTimer;
-        }
+    // 排在关闭之后的发送任务发现连接已断开，很快执行完毕
+    waitUntilIdle();
+
+    // 再等待一轮循环，让句柄关闭回调执行完毕，并确保唤醒本线程的循环线程已离开notifyIdle
+    if (closed) {
+        CUVLoop* loop = m_loop;
+        CUVPromise<void> promise;
+        CUVFuture<void> barrier = promise.getFuture();
+        postControlTask([loop, promise = std::move(promise)]() mutable {
+            loop->postDelayed(1, [promise = std::move(promise)]() mutable { promise.setValue(); });
+        });
+        barrier.wait();
     }
 
+    delete m_receiveTimeoutTimer;
+    delete m_writeQueue;
     // std::cout << "CUVTcpClient destroyed." << std::endl;
 }
 
+// 最后一个发送任务执行完毕或被丢弃时调用，仅在有线程等待时加锁通知
+void CUVTcpClient::notifyIdle()
+{
+    if (m_idleWaiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCond.notify_all();
+    }
+}
+
+// 等待已投递的发送任务全部执行完毕或被丢弃
+void CUVTcpClient::waitUntilIdle()
+{
+    m_idleWaiters.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_idleCond.wait(lock, [this]() { return m_pendingSends.load() == 0; });
+    }
+    m_idleWaiters.fetch_sub(1);
+}
+
+// 析构时在事件循环线程中关闭连接、取消定时器和合并发送，尚未写出的发送请求报告失败
+void CUVTcpClient::closeOnLoop()
+{
+    // 注销连接负载统计
+    if (m_state.exchange(ConnectState::DISCONNECTED) == ConnectState::CONNECTED) {
+        m_loop->removeConnection();
+    }
+
+    if (m_tcpHandle) {
+        uv_read_stop(reinterpret_cast<uv_stream_t*>(m_tcpHandle));
+        uv_close(reinterpret_cast<uv_handle_t*>(m_tcpHandle),
+                 [](uv_handle_t* handle) { delete reinterpret_cast<uv_tcp_t*>(handle); });
+        m_tcpHandle = nullptr;
+    }
+
+    stopReconnectTimer();
+    m_loop->getTimingWheel()->cancel(m_receiveTimeoutTimer);
+    m_loop->cancelFlush(m_writeQueue);
+    finishSends(m_writeQueue->requests, false, "Client destroyed");
+}
+
 // 连接服务器
 void CUVTcpClient::connect(const std::string& host, int port)
 {
@@ -105,8 +244,9 @@ void CUVTcpClient::connect(const std::string& host, int port)
         return;
     }
 
-    // 确保在事件循环线程中执行连接操作
-    postTask([this, host, port]() {
+    // 在事件循环线程中执行连接操作；已在循环线程中时（如重连任务）直接执行，
+    // 不再投递可能排在析构清理之后的任务
+    auto connectTask = [this, host, port]() {
         // 检查当前状态
         if (m_state.load() != ConnectState::DISCONNECTED) {
             if (m_connectCallback) {
@@ -180,7 +320,12 @@ void CUVTcpClient::connect(const std::string& host, int port)
             startReconnectTimer();
             return;
         }
-    });
+    };
+    if (m_loop->isInLoopThread()) {
+        connectTask();
+    } else {
+        postControlTask(std::move(connectTask));
+    }
 }
 
 // 断开连接
@@ -188,42 +333,56 @@ void CUVTcpClient::disconnect()
 {
     // 确保在事件循环线程中执行断开操作
     if (!isLoopValid()) {
-        if (m_disconnectCallback) {
-            m_disconnectCallback(false, "Invalid loop");
+        if (m_disconnectCallback && *m_disconnectCallback) {
+            (*m_disconnectCallback)(false, "Invalid loop");
         }
         return;
     }
 
     // 检查当前状态
-    if (m_state.load() == ConnectState::DISCONNECTED) {
-        if (m_disconnectCallback) {
-            m_disconnectCallback(true, "Client already disconnected");
+    ConnectState prevState = m_state.exchange(ConnectState::DISCONNECTED);
+    if (prevState == ConnectState::DISCONNECTED) {
+        if (m_disconnectCallback && *m_disconnectCallback) {
+            (*m_disconnectCallback)(true, "Client already disconnected");
         }
         return;
     }
-    m_state.store(ConnectState::DISCONNECTED);
+    if (prevState == ConnectState::CONNECTED) {
+        m_loop->removeConnection();
+    }
 
-    // 保存当前句柄和定时器指针，避免在回调中被修改
+    // 保存当前句柄和定时器指针，避免在回调中被修改；任务执行时客户端可能已经析构，不能访问this
     auto tcpHandle = m_tcpHandle;
     m_tcpHandle = nullptr;
+    CUVLoop* loop = m_loop;
     auto receiveTimeoutTimer = m_receiveTimeoutTimer;
-    m_receiveTimeoutTimer = nullptr;
     auto reconnectTimer = m_reconnectTimer;
-    m_reconnectTimer = nullptr;
-    // 在事件循环线程中执行断开操作
-    postTask([tcpHandle, receiveTimeoutTimer, reconnectTimer]() {
-        // 关闭接收超时定时器
-        deleteTimer(receiveTimeoutTimer);
+    auto disconnectRequest = new DisconnectRequest{m_disconnectCallback, m_receiveStrand};
+
+    // 在事件循环线程中执行断开操作；已在循环线程中时直接执行，
+    // 保证接收出错后紧接着启动的重连任务不会被随后才执行的取消操作取消
+    auto closeTask = [tcpHandle, loop, receiveTimeoutTimer, reconnectTimer, disconnectRequest]() {
+        // 取消重连任务，避免重复连接
+        loop->cancelTimer(*reconnectTimer);
+        *reconnectTimer = CUVLoop::TimerHandle();
 
-        // 停止重连定时器，避免重复连接
-        deleteTimer(reconnectTimer);
+        // 取消接收超时定时器
+        loop->getTimingWheel()->cancel(receiveTimeoutTimer);
 
         // 关闭TCP连接
         if (tcpHandle) {
             uv_read_stop(reinterpret_cast<uv_stream_t*>(tcpHandle));
+            tcpHandle->data = disconnectRequest;
             uv_close(reinterpret_cast<uv_handle_t*>(tcpHandle), onDisconnect);
+        } else {
+            delete disconnectRequest;
         }
-    });
+    };
+    if (loop->isInLoopThread()) {
+        closeTask();
+    } else {
+        postControlTask(std::move(closeTask));
+    }
 }
 
 // 获取连接状态
@@ -236,7 +395,9 @@ CUVTcpClient::ConnectState CUVTcpClient::getState() const
 void CUVTcpClient::send(const char* data, size_t length, SendCallback&& callback)
 {
     if (!data || length == 0) {
-        callback(false, "Invalid data");
+        if (callback) {
+            callback(false, "Invalid data");
+        }
         return;
     }
 
@@ -245,6 +406,12 @@ void CUVTcpClient::send(const char* data, size_t length, SendCallback&& callback
 
 // 发送数据（string版本）
 void CUVTcpClient::send(const std::string& data, SendCallback&& sendCallback)
+{
+    send(std::string(data), std::move(sendCallback));
+}
+
+// 发送数据（string右值版本，负载直接移动到发送请求中）
+void CUVTcpClient::send(std::string&& data, SendCallback&& sendCallback)
 {
     if (data.empty()) {
         if (sendCallback) {
@@ -260,22 +427,22 @@ void CUVTcpClient::send(const std::string& data, SendCallback&& sendCallback)
         return;
     }
 
-    // 确保在事件循环线程中执行发送操作
-    postTask([this, data, callback = std::move(sendCallback)]() {
+    // 创建发送请求，任务未执行就被销毁时由删除器回调发送失败
+    SendTicket request(new SendRequest{this, std::move(data), std::move(sendCallback)},
+                       this);
+    SendRequest* pending = request.get();
+
+    // 确保在事件循环线程中执行发送操作，客户端析构时等待发送任务执行完毕或被丢弃
+    auto send = [this, request = std::move(request)]() mutable {
         if (m_state.load() != ConnectState::CONNECTED) {
-            if (callback) {
-                callback(false, "Client is not connected");
-            }
+            failSend(request.get(), "Client is not connected");
             return;
         }
 
         // 检查写队列大小
         if (uv_stream_get_write_queue_size(reinterpret_cast<uv_stream_t*>(m_tcpHandle))
             > 1024 * 1024) {
-            std::string error_msg = "Write queue is too large, reconnecting...";
-            if (callback) {
-                callback(false, error_msg);
-            }
+            failSend(request.get(), "Write queue is too large, reconnecting...");
 
             // 断开连接并启动重连定时器
             disconnect();
@@ -283,32 +450,113 @@ void CUVTcpClient::send(const std::string& data, SendCallback&& sendCallback)
             return;
         }
 
-        // 创建发送请求
-        SendRequest* req_data = new SendRequest;
-        req_data->client = this;
-        req_data->data = data;
-        req_data->callback = std::move(callback);
+        // 放入发送队列，本轮循环末尾与同一轮的其他发送请求合并写出
+        if (m_writeQueue->requests.empty()) {
+            m_loop->scheduleFlush(m_writeQueue);
+        }
+        m_writeQueue->requests.push_back(request.release());
+    };
+    static_assert(sizeof(send) <= CUVTask::kInlineSize,
+                  "send task must fit in CUVTask inline storage");
+    CUVTask task(std::move(send));
+
+    // 在事件循环线程中（如在接收回调中回复）直接放入发送队列，不经过任务队列
+    if (m_loop->isInLoopThread()) {
+        task();
+        return;
+    }
 
-        // 创建uv_write_t请求
-        uv_write_t* req = new uv_write_t;
-        req->data = req_data;
+    // 任务队列已满时任务被拒绝，任务保持不变，取走回调后随任务一起销毁
+    if (!m_loop->postTask(std::move(task))) {
+        failSend(pending, "Task queue is full");
+    }
+}
 
-        uv_buf_t buf = uv_buf_init(const_cast<char*>(req_data->data.data()),
-                                   (ULONG) req_data->data.size());
-        int result = uv_write(req,
-                              reinterpret_cast<uv_stream_t*>(m_tcpHandle),
-                              &buf,
-                              1,
-                              CUVTcpClient::onSend);
-        if (result != 0) {
-            if (req_data->callback) {
-                req_data->callback(false,
-                                   "Failed to initiate send: " + std::string(uv_strerror(result)));
-            }
-            delete req;
-            delete req_data;
+// 把发送队列中的全部发送请求作为一个缓冲区数组写出：先用uv_try_write直接写入套接字，
+// 全部写完时不创建写请求，回调在本轮循环中调用；只有未写完的部分交给uv_write排队
+void CUVTcpClient::flushSends()
+{
+    std::vector<SendRequest*>& queued = m_writeQueue->requests;
+    if (queued.empty()) {
+        return;
+    }
+
+    // 取出整批请求，回调中新的发送进入下一批
+    std::vector<SendRequest*> requests;
+    requests.swap(queued);
+
+    // 排队之后连接已断开
+    if (m_state.load() != ConnectState::CONNECTED || !m_tcpHandle) {
+        finishSends(requests, false, "Client is not connected");
+        return;
+    }
+
+    uv_stream_t* stream = reinterpret_cast<uv_stream_t*>(m_tcpHandle);
+    size_t bytes = 0;
+    m_writeBufs.clear();
+    for (SendRequest* request : requests) {
+        m_writeBufs.push_back(
+            uv_buf_init(const_cast<char*>(request->data.data()), (unsigned int) request->data.size()));
+        bytes += request->data.size();
+    }
+
+    // libuv写队列不为空或套接字缓冲区已满时返回UV_EAGAIN，句柄不支持直接写入时返回UV_ENOSYS，
+    // 此时全部交给uv_write；其他错误（连接已重置或关闭）整批失败
+    int written = uv_try_write(stream,
+                               m_writeBufs.data(),
+                               static_cast<unsigned int>(m_writeBufs.size()));
+    if (written == UV_EAGAIN || written == UV_ENOSYS) {
+        written = 0;
+    } else if (written < 0) {
+        finishSends(requests,
+                    false,
+                    "Failed to send: " + std::string(uv_strerror(written)));
+        return;
+    }
+    m_immediateBytes.fetch_add(written, std::memory_order_relaxed);
+
+    if (static_cast<size_t>(written) == bytes) {
+        finishSends(requests, true, "");
+        // 回调中没有新的发送时把数组容量还给发送队列，下一轮不再分配
+        if (queued.empty()) {
+            queued.swap(requests);
         }
-    });
+        return;
+    }
+
+    // 跳过已写出的部分，剩余部分排队
+    size_t first = 0;
+    size_t offset = static_cast<size_t>(written);
+    while (offset >= m_writeBufs[first].len) {
+        offset -= m_writeBufs[first].len;
+        ++first;
+    }
+    m_writeBufs[first].base += offset;
+    m_writeBufs[first].len -= (decltype(uv_buf_t::len)) offset;
+    m_queuedBytes.fetch_add(bytes - written, std::memory_order_relaxed);
+
+    WriteBatch* batch = new WriteBatch;
+    batch->req.data = batch;
+    batch->requests.swap(requests);
+
+    int result = uv_write(&batch->req,
+                          stream,
+                          m_writeBufs.data() + first,
+                          static_cast<unsigned int>(m_writeBufs.size() - first),
+                          CUVTcpClient::onSend);
+    if (result != 0) {
+        finishSends(batch->requests,
+                    false,
+                    "Failed to initiate send: " + std::string(uv_strerror(result)));
+        delete batch;
+    }
+}
+
+// 获取发送统计信息
+CUVTcpClient::SendStats CUVTcpClient::getSendStats() const
+{
+    return SendStats{m_immediateBytes.load(std::memory_order_relaxed),
+                     m_queuedBytes.load(std::memory_order_relaxed)};
 }
 
 // ==================== 回调设置方法 ====================
@@ -316,7 +564,7 @@ void CUVTcpClient::send(const std::string& data, SendCallback&& sendCallback)
 // 设置接收回调
 void CUVTcpClient::setReceiveCallback(ReceiveCallback&& callback)
 {
-    m_receiveCallback = std::move(callback);
+    m_receiveCallback = std::make_shared<const ReceiveCallback>(std::move(callback));
 }
 
 // 设置连接回调
@@ -328,7 +576,13 @@ void CUVTcpClient::setConnectCallback(ConnectCallback&& callback)
 // 设置断开回调
 void CUVTcpClient::setDisconnectCallback(DisconnectCallback&& callback)
 {
-    m_disconnectCallback = std::move(callback);
+    m_disconnectCallback = std::make_shared<const DisconnectCallback>(std::move(callback));
+}
+
+// 设置接收回调的卸载线程池
+void CUVTcpClient::setReceiveDispatcher(CUVWorkerPool* pool)
+{
+    m_receiveStrand = pool ? pool->createStrand() : nullptr;
 }
 
 void CUVTcpClient::setReconnectCallback(ReconnectCallback&& callback)
@@ -365,47 +619,35 @@ void CUVTcpClient::setReceiveTimeout(int timeoutMs, TimeoutCallback callback)
 
 void CUVTcpClient::startReconnectTimer()
 {
-    if (!isLoopValid()) {
+    if (!isLoopValid() || m_state.load() != ConnectState::DISCONNECTED) {
         return;
     }
 
-    postTask([this]() {
-        if (m_state.load() != ConnectState::DISCONNECTED) {
-            return;
+    // 重新计时，取消尚未触发的重连任务
+    m_loop->cancelTimer(*m_reconnectTimer);
+    *m_reconnectTimer = m_loop->postDelayed(m_reconnectInterval, [this]() {
+        if (m_state.load() == ConnectState::DISCONNECTED) {
+            if (m_reconnectCallback) {
+                m_reconnectCallback("Attempting to reconnect to " + m_host + ":"
+                                    + std::to_string(m_port));
+            }
+            connect(m_host, m_port);
         }
-
-        // 使用通用定时器管理函数启动重连定时器
-        startTimer(
-            &m_reconnectTimer,
-            m_reconnectInterval,
-            [](uv_timer_t* handle) {
-                CUVTcpClient* client = static_cast<CUVTcpClient*>(handle->data);
-
-                if (client->m_state.load() == ConnectState::DISCONNECTED) {
-                    if (client->m_reconnectCallback) {
-                        client->m_reconnectCallback("Attempting to reconnect to " + client->m_host
-                                                    + ":" + std::to_string(client->m_port));
-                    }
-                    client->connect(client->m_host, client->m_port);
-                }
-            },
-            "Failed to initialize reconnect timer: ",
-            "Failed to start reconnect timer: ",
-            m_reconnectCallback);
     });
+
+    if (!*m_reconnectTimer && m_reconnectCallback) {
+        m_reconnectCallback("Failed to start reconnect timer");
+    }
 }
 
 void CUVTcpClient::stopReconnectTimer()
 {
-    if (!isLoopValid() || !m_reconnectTimer) {
+    if (!isLoopValid()) {
         return;
     }
 
-    postTask([this]() {
-        if (m_reconnectTimer) {
-            uv_timer_stop(m_reconnectTimer);
-        }
-    });
+    m_loop->cancelTimer(*m_reconnectTimer);
+    *m_reconnectTimer = CUVLoop::TimerHandle();
 }
 
 // ==================== 接收超时定时器相关方法 ====================
@@ -419,7 +661,7 @@ void CUVTcpClient::startReceiveTimeoutTimer()
         return;
     }
 
-    postTask([this]() {
+    postControlTask([this]() {
         if (m_state.load() != ConnectState::CONNECTED) {
             if (m_receiveTimeoutCallback) {
                 m_receiveTimeoutCallback("Client is not connected.");
@@ -427,25 +669,7 @@ void CUVTcpClient::startReceiveTimeoutTimer()
             return;
         }
 
-        // 使用通用定时器管理函数启动接收超时定时器
-        startTimer(
-            &m_receiveTimeoutTimer,
-            m_receiveTimeoutInterval,
-            [](uv_timer_t* handle) {
-                CUVTcpClient* client = static_cast<CUVTcpClient*>(handle->data);
-
-                // 调用超时回调
-                if (client->m_receiveTimeoutCallback) {
-                    client->m_receiveTimeoutCallback("Receive timeout occurred.");
-                }
-
-                // 断开连接并尝试重新连接
-                client->disconnect();
-                client->startReconnectTimer();
-            },
-            "Failed to initialize receive timeout timer: ",
-            "Failed to start receive timeout timer: ",
-            m_receiveTimeoutCallback);
+        resetReceiveTimeoutTimer();
     });
 }
 
@@ -455,13 +679,19 @@ void CUVTcpClient::stopReceiveTimeoutTimer()
         return;
     }
 
-    postTask([this]() {
-        if (m_receiveTimeoutTimer) {
-            uv_timer_stop(m_receiveTimeoutTimer);
-        }
+    postControlTask([this]() {
+        m_loop->getTimingWheel()->cancel(m_receiveTimeoutTimer);
     });
 }
 
+// 重新开始接收超时计时，已在计时中时时间轮只更新到期时间
+void CUVTcpClient::resetReceiveTimeoutTimer()
+{
+    if (m_receiveTimeoutTimer && m_receiveTimeoutInterval > 0) {
+        m_loop->getTimingWheel()->schedule(m_receiveTimeoutTimer, m_receiveTimeoutInterval);
+    }
+}
+
 // ==================== 辅助函数实现 ====================
 
 // 向事件循环发布任务
@@ -473,46 +703,13 @@ void CUVTcpClient::postTask(Func&& func) const
     }
 }
 
-// 通用定时器管理函数
-template<typename CallbackFunc>
-bool CUVTcpClient::startTimer(uv_timer_t** timer_ptr,
-                              int interval_ms,
-                              CallbackFunc callback,
-                              const std::string& init_error_msg,
-                              const std::string& start_error_msg,
-                              std::function<void(const std::string&)>& timer_callback)
+// 向事件循环发布控制类任务（连接、断开、定时器），优先于数据发送执行
+template<typename Func>
+void CUVTcpClient::postControlTask(Func&& func) const
 {
-    if (!timer_ptr)
-        return false;
-
-    // 初始化定时器
-    if (!*timer_ptr) {
-        *timer_ptr = new uv_timer_t;
-        std::memset(*timer_ptr, 0, sizeof(uv_timer_t));
-        (*timer_ptr)->data = this;
-
-        if (uv_timer_init(m_loop->getLoop(), *timer_ptr) != 0) {
-            delete *timer_ptr;
-            *timer_ptr = nullptr;
-            if (timer_callback) {
-                timer_callback(init_error_msg + "failed");
-            }
-            return false;
-        }
-    }
-
-    // 先停止定时器，确保状态正确
-    uv_timer_stop(*timer_ptr);
-
-    // 启动定时器
-    if (uv_timer_start(*timer_ptr, callback, interval_ms, 0) != 0) {
-        if (timer_callback) {
-            timer_callback(start_error_msg + "failed");
-        }
-        return false;
+    if (isLoopValid()) {
+        m_loop->postTask(std::forward<Func>(func), CUVLoop::TaskPriority::HIGH);
     }
-
-    return true;
 }
 
 // ==================== 静态回调函数实现 ====================
@@ -530,24 +727,22 @@ void CUVTcpClient::onConnect(uv_connect_t* req, int status)
         // 连接失败，增加重连间隔
         client->m_reconnectInterval = (std::min) (client->m_reconnectInterval * 2,
                                                   client->m_maxReconnectInterval);
-        // 启动重连定时器
-        client->startReconnectTimer();
+        // 启动重连定时器；连接被disconnect()取消时不再重连
+        if (status != UV_ECANCELED) {
+            client->startReconnectTimer();
+        }
     } else {
         client->m_state.store(ConnectState::CONNECTED);
+        client->m_loop->addConnection();
         client->m_reconnectInterval = client->m_initialReconnectInterval;
 
         // 开始接收数据
-        uv_read_start(
-            reinterpret_cast<uv_stream_t*>(client->m_tcpHandle),
-            [](uv_handle_t*, size_t suggested_size, uv_buf_t* buf) {
-                buf->base = new char[suggested_size];
-                buf->len = (ULONG) suggested_size;
-            },
-            CUVTcpClient::onReceive);
+        uv_read_start(reinterpret_cast<uv_stream_t*>(client->m_tcpHandle),
+                      CUVTcpClient::onAlloc,
+                      CUVTcpClient::onReceive);
 
         // 重置接收超时定时器
-        client->stopReceiveTimeoutTimer();
-        client->startReceiveTimeoutTimer();
+        client->resetReceiveTimeoutTimer();
     }
 
     // 调用用户回调
@@ -563,50 +758,92 @@ void CUVTcpClient::onConnect(uv_connect_t* req, int status)
 // 断开回调处理
 void CUVTcpClient::onDisconnect(uv_handle_t* handle)
 {
-    auto client = static_cast<CUVTcpClient*>(handle->data);
-
-    // 调用用户断开回调
-    if (client->m_disconnectCallback) {
-        client->m_disconnectCallback(true, "Disconnected successfully");
+    auto disconnectRequest = static_cast<DisconnectRequest*>(handle->data);
+
+    // 调用用户断开回调，卸载模式下排在尚未执行的接收回调之后
+    const auto& disconnectCallback = disconnectRequest->callback;
+    if (disconnectCallback && *disconnectCallback) {
+        if (disconnectRequest->strand) {
+            disconnectRequest->strand->post([disconnectCallback]() {
+                (*disconnectCallback)(true, "Disconnected successfully");
+            });
+        } else {
+            (*disconnectCallback)(true, "Disconnected successfully");
+        }
     }
 
-    // 清理TCP句柄
+    // 清理断开请求和TCP句柄
+    delete disconnectRequest;
     delete reinterpret_cast<uv_tcp_t*>(handle);
 }
 
-// 发送回调处理
+// 发送回调处理，一批发送请求一起完成
 void CUVTcpClient::onSend(uv_write_t* req, int status)
 {
-    SendRequest* req_data = static_cast<SendRequest*>(req->data);
+    WriteBatch* batch = static_cast<WriteBatch*>(req->data);
+    finishSends(batch->requests, status == 0, (status != 0) ? uv_strerror(status) : "");
+    delete batch;
+}
 
-    // 调用用户回调
-    if (req_data->callback) {
-        std::string error = (status != 0) ? uv_strerror(status) : "";
-        req_data->callback(status == 0, error);
-    }
+// 循环末尾合并写出
+void CUVTcpClient::onFlush(CUVLoop::FlushHook* hook)
+{
+    static_cast<CUVTcpClient*>(hook->data)->flushSends();
+}
 
-    // 清理资源
-    delete req_data;
-    delete req;
+// 分配读缓冲区：从循环的缓冲池中取用，尺寸由最近的读取大小决定
+void CUVTcpClient::onAlloc(uv_handle_t* handle, size_t, uv_buf_t* buf)
+{
+    CUVTcpClient* client = static_cast<CUVTcpClient*>(handle->data);
+    size_t capacity = 0;
+    buf->base = client->m_loop->getBufferPool()->acquire(client->m_readSize.next(), &capacity);
+    buf->len = (decltype(uv_buf_t::len)) capacity;
 }
 
 // 接收回调处理
 void CUVTcpClient::onReceive(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
 {
     CUVTcpClient* client = static_cast<CUVTcpClient*>(stream->data);
+    CUVBufferPool* bufferPool = client->m_loop->getBufferPool();
 
     if (nread > 0) {
-        if (client->m_receiveCallback) {
-            client->m_receiveCallback(buf->base, nread);
+        client->m_readSize.record(static_cast<size_t>(nread), buf->len);
+
+        const auto& receiveCallback = client->m_receiveCallback;
+        if (receiveCallback && *receiveCallback) {
+            if (client->m_receiveStrand) {
+                // 卸载模式下缓冲区的所有权直接转移给工作线程，不再拷贝，由工作线程归还
+                client->m_receiveStrand->post(
+                    [receiveCallback, data = bufferPool->adopt(buf->base, nread)]() {
+                        (*receiveCallback)(data.data(), data.size());
+                    });
+                client->resetReceiveTimeoutTimer();
+                return;
+            }
+            (*receiveCallback)(buf->base, nread);
         }
         // 重置接收超时定时器
-        client->stopReceiveTimeoutTimer();
-        client->startReceiveTimeoutTimer();
+        client->resetReceiveTimeoutTimer();
     } else if (nread < 0) {
         client->disconnect();
         client->startReconnectTimer();
     }
 
-    // 释放缓冲区
-    delete[] buf->base;
+    // 归还缓冲区
+    bufferPool->release(buf->base);
+}
+
+// 接收超时回调处理
+void CUVTcpClient::onReceiveTimeout(CUVTimingWheel::Timer* timer)
+{
+    CUVTcpClient* client = static_cast<CUVTcpClient*>(timer->data);
+
+    // 调用超时回调
+    if (client->m_receiveTimeoutCallback) {
+        client->m_receiveTimeoutCallback("Receive timeout occurred.");
+    }
+
+    // 断开连接并尝试重新连接
+    client->disconnect();
+    client->startReconnectTimer();
 }
@@ -2,8 +2,15 @@
 #define CUVTCPCLIENT_H
 
 #include "common/network/base/CUVLoop.h"
+#include "common/network/base/CUVWorkerPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace Common {
 namespace Network {
@@ -15,26 +22,39 @@ private:
     static void onConnect(uv_connect_t* req, int status);
     static void onDisconnect(uv_handle_t* handle);
     static void onSend(uv_write_t* req, int status);
+    static void onFlush(CUVLoop::FlushHook* hook);
+    static void onAlloc(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf);
     static void onReceive(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+    static void onReceiveTimeout(CUVTimingWheel::Timer* timer);
 
-    // 重连定时器控制
+    // 重连定时器控制，仅在事件循环线程中调用
     void startReconnectTimer();
     void stopReconnectTimer();
 
     // 接收超时定时器控制
     void startReceiveTimeoutTimer();
     void stopReceiveTimeoutTimer();
+    void resetReceiveTimeoutTimer(); // 仅在事件循环线程中调用
+
+    // 合并发送：同一轮循环中的发送请求在循环末尾合并为一次写请求
+    struct WriteBatch;
+    struct WriteQueue;
+    void flushSends(); // 仅在事件循环线程中调用
+
+    // 析构时关闭连接并取消定时器，仅在事件循环线程中调用
+    void closeOnLoop();
+
+    // 发送任务凭据：最后一个发送任务执行完毕或被丢弃时唤醒等待的析构函数
+    class SendTicket;
+    void notifyIdle();
+    void waitUntilIdle();
 
     // 辅助函数
     template<typename Func>
     void postTask(Func&& func) const;
+    template<typename Func>
+    void postControlTask(Func&& func) const;
     inline bool isLoopValid() const { return m_loop != nullptr; }
-    
-    // 通用定时器管理函数
-    template<typename CallbackFunc>
-    bool startTimer(uv_timer_t** timer_ptr, int interval_ms, CallbackFunc callback,
-                   const std::string& init_error_msg, const std::string& start_error_msg,
-                   std::function<void(const std::string&)>& timer_callback);
 
 public:
     // 连接状态
@@ -48,10 +68,23 @@ public:
     using ReconnectCallback = std::function<void(const std::string& error)>;          // 重连回调
     using TimeoutCallback = std::function<void(const std::string& error)>;            // 超时回调
 
+    // 发送统计信息
+    struct SendStats
+    {
+        uint64_t immediateBytes; // 由uv_try_write直接写入套接字的字节数
+        uint64_t queuedBytes;    // 未能直接写入、进入libuv写队列的字节数
+    };
+
     /**
      * @brief 构造函数
+     * @param loop 事件循环，必须比客户端存活更久；nullptr表示从全局默认循环池中选择负载最小的循环
+     */
+    explicit CUVTcpClient(CUVLoop* loop = nullptr);
+
+    /**
+     * @brief 析构函数，关闭连接并等待已投递的任务和发送任务执行完毕
+     * @details 前置条件：不在客户端所在事件循环的线程中调用
      */
-    explicit CUVTcpClient();
     ~CUVTcpClient();
 
     // 禁止拷贝和移动
@@ -68,9 +101,15 @@ public:
     // 获取连接状态
     ConnectState getState() const;
 
-    // 发送数据
+    // 发送数据，同一轮循环中的多次发送在循环末尾合并，先用uv_try_write直接写入套接字，
+    // 只有未写完的部分进入libuv写队列，回调仍逐条调用；在事件循环线程中调用时不经过任务队列；
+    // 发送任务被DROP_OLDEST策略挤出队列或随事件循环停止而丢弃时，在销毁任务的线程中以失败回调
     void send(const char* data, size_t length, SendCallback&& callback = nullptr);
     void send(const std::string& data, SendCallback&& callback = nullptr);
+    void send(std::string&& data, SendCallback&& callback = nullptr);
+
+    // 获取发送统计信息
+    SendStats getSendStats() const;
 
     // 设置回调
     void setReceiveCallback(ReceiveCallback&& callback);
@@ -78,6 +117,14 @@ public:
     void setDisconnectCallback(DisconnectCallback&& callback);
     void setReconnectCallback(ReconnectCallback&& callback);
 
+    /**
+     * @brief 设置接收回调的卸载线程池，必须在connect()之前调用
+     * @details 设置后接收回调和断开回调在线程池中按顺序串行执行，接收缓冲区直接转交给工作线程；
+     *          线程池必须比客户端存活更久
+     * @param pool 工作线程池，nullptr表示在事件循环线程中执行
+     */
+    void setReceiveDispatcher(CUVWorkerPool* pool);
+
     // 配置重连机制
     void setReconnectInterval(int initialIntervalMs = 1000, int maxIntervalMs = 30000);
 
@@ -92,19 +139,33 @@ private:
     std::string m_host;                // 服务器地址
     int m_port;                        // 服务器端口
 
-    uv_timer_t* m_reconnectTimer;   // 重连定时器
-    int m_reconnectInterval;        // 当前重连间隔
-    int m_initialReconnectInterval; // 初始重连间隔
-    int m_maxReconnectInterval;     // 最大重连间隔
+    std::shared_ptr<CUVLoop::TimerHandle> m_reconnectTimer; // 重连定时任务，仅在事件循环线程中访问
+    int m_reconnectInterval;                                // 当前重连间隔
+    int m_initialReconnectInterval;                         // 初始重连间隔
+    int m_maxReconnectInterval;                             // 最大重连间隔
 
-    uv_timer_t* m_receiveTimeoutTimer; // 接收超时定时器
-    int m_receiveTimeoutInterval;      // 接收超时间隔
+    CUVTimingWheel::Timer* m_receiveTimeoutTimer; // 接收超时定时器（挂在循环的时间轮上）
+    int m_receiveTimeoutInterval;                 // 接收超时间隔
+
+    CUVBufferPool::ReadSizeEstimator m_readSize; // 读取大小估计，仅在事件循环线程中访问
+
+    WriteQueue* m_writeQueue;               // 合并发送队列（挂在循环上），内容仅在循环线程中访问
+    std::vector<uv_buf_t> m_writeBufs;      // 合并写出时的缓冲区描述数组，复用以免每次分配
+    std::atomic<size_t> m_pendingSends;     // 已投递、尚未执行或丢弃的发送任务数
+    std::mutex m_idleMutex;                 // 等待发送任务归零的互斥锁
+    std::condition_variable m_idleCond;     // 发送任务归零时通知析构函数
+    std::atomic<size_t> m_idleWaiters;      // 正在等待发送任务归零的线程数
+    std::atomic<uint64_t> m_immediateBytes; // 由uv_try_write直接写出的字节数
+    std::atomic<uint64_t> m_queuedBytes;    // 进入libuv写队列的字节数
 
     ConnectCallback m_connectCallback;        // 连接回调
-    DisconnectCallback m_disconnectCallback;  // 断开回调
-    ReceiveCallback m_receiveCallback;        // 接收数据回调
     TimeoutCallback m_receiveTimeoutCallback; // 接收超时回调
     ReconnectCallback m_reconnectCallback;    // 重连回调
+
+    // 接收和断开回调由卸载任务共享持有，客户端销毁后仍在排队的回调可以安全执行
+    std::shared_ptr<const DisconnectCallback> m_disconnectCallback; // 断开回调
+    std::shared_ptr<const ReceiveCallback> m_receiveCallback;       // 接收数据回调
+    std::shared_ptr<CUVWorkerPool::Strand> m_receiveStrand;         // 接收回调的串行执行器（仅卸载模式）
 };
 
 } // namespace Network
@@ -1,10 +1,25 @@
 #include "CUVTcpServer.h"
+#include "common/network/base/CUVLoopPool.h"
 // #include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
 #include <utility>
 #include <uv.h>
 
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
+// 连接ID中分片索引的起始位，低位为分片客户端表的槽位键
+constexpr int kConnectionShardShift = 48;
+
 Address getAddress(uv_tcp_t* clientHandle)
 {
     Address address;
@@ -23,24 +38,324 @@ Address getAddress(uv_tcp_t* clientHandle)
     return address;
 }
 
+// 创建设置了SO_REUSEPORT的TCP套接字，成功时将其交给handle
+int openReusePortSocket(uv_tcp_t* handle)
+{
+#ifdef _WIN32
+    (void) handle;
+    return UV_ENOTSUP;
+#else
+    int sock = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return uv_translate_sys_error(errno);
+    }
+
+    int on = 1;
+    if (::setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+        int result = uv_translate_sys_error(errno);
+        ::close(sock);
+        return result;
+    }
+
+    int result = uv_tcp_open(handle, sock);
+    if (result != 0) {
+        ::close(sock);
+    }
+    return result;
+#endif
+}
+
+// 复制已接受连接的套接字，使其可以在另一个事件循环中通过uv_tcp_open重新打开；
+// Windows上已接受的套接字关联在接收循环的IOCP上，复制后无法在其他循环中使用，改用IPC管道移交
+int duplicateSocket(uv_tcp_t* handle, uv_os_sock_t* dupSock)
+{
+#ifdef _WIN32
+    (void) handle;
+    (void) dupSock;
+    return UV_ENOTSUP;
+#else
+    uv_os_fd_t fd;
+    if (int result = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd); result != 0) {
+        return result;
+    }
+
+    int sock = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (sock < 0) {
+        return uv_translate_sys_error(errno);
+    }
+    *dupSock = sock;
+    return 0;
+#endif
+}
+
+// 关闭尚未交给libuv管理的套接字
+void closeSocket(uv_os_sock_t sock)
+{
+#ifdef _WIN32
+    ::closesocket(sock);
+#else
+    ::close(sock);
+#endif
+}
+
+// ACCEPTOR模式是否经IPC管道移交连接：接收分片用uv_write2发送句柄，工作分片用uv_accept接收
+#ifdef _WIN32
+constexpr bool kHandOffOverPipe = true;
+#else
+constexpr bool kHandOffOverPipe = false;
+#endif
+
+// 移交管道的名称，每个服务器的每个工作分片一条
+std::string handOffPipeName(const void* server, size_t workerIndex)
+{
+    std::string name = "CUVTcpServer-" + std::to_string(uv_os_getpid()) + "-"
+                       + std::to_string(reinterpret_cast<uintptr_t>(server)) + "-"
+                       + std::to_string(workerIndex);
+#ifdef _WIN32
+    return "\\\\.\\pipe\\" + name;
+#else
+    char tmpDir[256];
+    size_t size = sizeof(tmpDir);
+    if (uv_os_tmpdir(tmpDir, &size) != 0) {
+        return "/tmp/" + name + ".sock";
+    }
+    return std::string(tmpDir, size) + "/" + name + ".sock";
+#endif
+}
+
+// 移交管道的名称可以被枚举，只接受本进程内工作分片的连接，
+// 否则抢先连上的其他本地进程或远程客户端会收到该工作分片的所有连接
+bool isHandOffPeer(uv_pipe_t* pipe)
+{
+#ifdef _WIN32
+    uv_os_fd_t handle;
+    if (uv_fileno(reinterpret_cast<uv_handle_t*>(pipe), &handle) != 0) {
+        return false;
+    }
+
+    // 本地客户端无法取得计算机名，取得即为远程客户端
+    WCHAR computerName[MAX_COMPUTERNAME_LENGTH + 1];
+    if (GetNamedPipeClientComputerNameW(handle, computerName, sizeof(computerName))) {
+        return false;
+    }
+
+    ULONG pid = 0;
+    return GetNamedPipeClientProcessId(handle, &pid) && pid == (ULONG) uv_os_getpid();
+#else
+    (void) pipe;
+    return true;
+#endif
+}
+
+// 关闭并释放管道句柄
+void deletePipeHandle(uv_pipe_t* pipe)
+{
+    if (pipe && !uv_is_closing(reinterpret_cast<uv_handle_t*>(pipe))) {
+        uv_close(reinterpret_cast<uv_handle_t*>(pipe),
+                 [](uv_handle_t* handle) { delete reinterpret_cast<uv_pipe_t*>(handle); });
+    }
+}
+
 } // namespace
 
 using namespace Common::Network;
 
+// 移交写请求，附带的接受时间戳作为uv_write2的数据一起发给工作分片
+struct CUVTcpServer::HandOffRequest
+{
+    uv_write_t req;
+    uv_tcp_t* clientHandle;
+    Shard* worker;
+    uint64_t acceptTime;
+};
+
+// 合并写请求数据结构，持有一轮循环中排队的全部消息直到写完成
+struct WriteBatch
+{
+    uv_write_t req;
+    CUVTcpServer::ClientContext* clientCtx;
+    std::vector<std::string> messages;
+    uint64_t bytes;
+};
+
+// 发送任务凭据，随发送任务一起移动；数据放入连接的发送队列之前被销毁时（找不到客户端、
+// 任务被拒绝或随事件循环停止而丢弃）计为丢弃，之后由finishWrites统计写出或丢弃；
+// 任务未执行就被销毁时（被拒绝、被DROP_OLDEST策略挤出队列或随事件循环停止而丢弃）
+// 由凭据调用发送回调报告失败，此时回调在销毁任务的线程中调用
+class CUVTcpServer::SendTicket
+{
+public:
+    SendTicket(Shard* shard, size_t bytes, const Address& clientAddr)
+        : m_shard(shard)
+        , m_bytes(bytes)
+        , m_connectionId(clientAddr.connectionId)
+        , m_ip(clientAddr.ip)
+        , m_port(clientAddr.port)
+        , m_executed(false)
+    {
+        m_shard->pendingSends.fetch_add(1);
+    }
+
+    SendTicket(SendTicket&& other) noexcept
+        : m_shard(std::exchange(other.m_shard, nullptr))
+        , m_bytes(other.m_bytes)
+        , m_connectionId(other.m_connectionId)
+        , m_ip(std::move(other.m_ip))
+        , m_port(other.m_port)
+        , m_executed(other.m_executed)
+    {}
+
+    ~SendTicket()
+    {
+        if (m_shard) {
+            m_shard->droppedBytes.fetch_add(m_bytes, std::memory_order_relaxed);
+            // 在计数归零之前回调，服务器等待发送任务完成后才会析构
+            const SendCallback& sendCallback = m_shard->server->m_sendCallback;
+            if (!m_executed && sendCallback) {
+                sendCallback(clientAddr(), false, "CUVTcpServer: Send task dropped.");
+            }
+            if (m_shard->pendingSends.fetch_sub(1) == 1) {
+                m_shard->server->notifyIdle();
+            }
+        }
+    }
+
+    // 禁止拷贝
+    SendTicket(const SendTicket&) = delete;
+    SendTicket& operator=(const SendTicket&) = delete;
+
+    Shard* shard() const { return m_shard; }
+    ConnectionId connectionId() const { return m_connectionId; }
+    Address clientAddr() const { return Address{m_ip, m_port, m_shard->index, m_connectionId}; }
+
+    // 发送任务开始执行，之后的失败由任务自己报告
+    void execute() { m_executed = true; }
+
+    // 数据已放入连接的发送队列
+    void commit()
+    {
+        m_shard->pendingWriteBytes.fetch_add(m_bytes);
+        m_bytes = 0;
+    }
+
+private:
+    // 只保存报告失败所需的地址字段，发送任务连同数据不超出CUVTask的内联存储
+    Shard* m_shard;              // 目标分片
+    size_t m_bytes;              // 尚未提交的字节数
+    ConnectionId m_connectionId; // 目标连接ID
+    std::string m_ip;            // 目标客户端IP
+    int m_port;                  // 目标客户端端口
+    bool m_executed;             // 发送任务是否已开始执行
+};
+
+// 手工构造地址的发送：数据由各分片的查找任务共享，找到客户端的分片取走数据
+struct CUVTcpServer::AddressLookup
+{
+    AddressLookup(const Address& clientAddr, std::string&& data, size_t shardCount)
+        : clientAddr(clientAddr)
+        , data(std::move(data))
+        , remaining(shardCount)
+        , claimed(false)
+        , dropped(false)
+    {}
+
+    Address clientAddr;             // 目标客户端地址
+    std::string data;               // 要发送的数据，取得之后被移走
+    std::atomic<size_t> remaining;  // 尚未结束的查找任务数
+    std::atomic<bool> claimed;      // 是否已有分片找到客户端并取走数据
+    std::atomic<bool> dropped;      // 是否有查找任务未执行就被丢弃
+};
+
+// 查找任务凭据，随查找任务一起移动，计入分片的待执行发送任务数；
+// 最后一个结束的查找任务仍没有分片找到客户端时，以失败调用发送回调
+class CUVTcpServer::LookupTicket
+{
+public:
+    LookupTicket(Shard* shard, std::shared_ptr<AddressLookup> lookup)
+        : m_shard(shard)
+        , m_lookup(std::move(lookup))
+        , m_executed(false)
+    {
+        m_shard->pendingSends.fetch_add(1);
+    }
+
+    LookupTicket(LookupTicket&& other) noexcept
+        : m_shard(std::exchange(other.m_shard, nullptr))
+        , m_lookup(std::move(other.m_lookup))
+        , m_executed(other.m_executed)
+    {}
+
+    ~LookupTicket()
+    {
+        if (!m_shard) {
+            return;
+        }
+        if (!m_executed) {
+            m_lookup->dropped.store(true);
+        }
+        if (m_lookup->remaining.fetch_sub(1) == 1 && !m_lookup->claimed.load()) {
+            m_shard->droppedBytes.fetch_add(m_lookup->data.size(), std::memory_order_relaxed);
+            // 在计数归零之前回调，服务器等待发送任务完成后才会析构
+            if (const SendCallback& sendCallback = m_shard->server->m_sendCallback) {
+                sendCallback(m_lookup->clientAddr,
+                             false,
+                             m_lookup->dropped.load() ? "CUVTcpServer: Send task dropped."
+                                                      : "CUVTcpServer: Client not found.");
+            }
+        }
+        if (m_shard->pendingSends.fetch_sub(1) == 1) {
+            m_shard->server->notifyIdle();
+        }
+    }
+
+    // 禁止拷贝
+    LookupTicket(const LookupTicket&) = delete;
+    LookupTicket& operator=(const LookupTicket&) = delete;
+
+    Shard* shard() const { return m_shard; }
+    const std::shared_ptr<AddressLookup>& lookup() const { return m_lookup; }
+
+    // 查找任务开始执行
+    void execute() { m_executed = true; }
+
+private:
+    Shard* m_shard;                         // 查找的分片
+    std::shared_ptr<AddressLookup> m_lookup; // 各分片共享的查找状态
+    bool m_executed;                        // 查找任务是否已开始执行
+};
+
 // 构造函数
-CUVTcpServer::CUVTcpServer()
-    : m_loop(CUVLoop::getInstance())
-    , m_serverHandle(nullptr)
+CUVTcpServer::CUVTcpServer(CUVLoop* loop, CUVLoopPool* loopPool)
+    : m_loop(loop)
+    , m_loopPool(loopPool ? loopPool : CUVLoopPool::getInstance())
     , m_state(ServerState::STOPPED)
+    , m_listenMode(ListenMode::SINGLE)
+    , m_acceptor(nullptr)
+    , m_pendingShards(0)
+    , m_startedShards(0)
     , m_listenAddress({"", 0})
     , m_maxConnections(1000)
     , m_receiveTimeoutInterval(0)
-{}
+    , m_receiveDispatcher(nullptr)
+    , m_idleWaiters(0)
+{
+    if (!m_loop) {
+        m_loop = m_loopPool->nextLoop();
+    }
+    setListenMode(ListenMode::SINGLE);
+}
 
 // 析构函数
 CUVTcpServer::~CUVTcpServer()
 {
+    // 前置条件：不在分片的循环线程中析构，否则无法等待关闭完成，
+    // 投递的关闭任务和句柄回调会访问已释放的分片
+    assert(!isInShardLoopThread());
+
+    // 之前的stop()可能是在事件循环线程中调用的，释放分片之前再确认一次关闭已完成
     stop();
+    waitForShards();
+    clearShards();
     // std::cout << "CUVTcpServer: Server destroyed." << std::endl;
 }
 
@@ -67,19 +382,199 @@ void CUVTcpServer::closeClientConnection(uv_tcp_t* clientHandle) const
 
 void CUVTcpServer::deleteClientHandle(uv_tcp_t* clientHandle)
 {
-    if (clientHandle) {
-        uv_close(reinterpret_cast<uv_handle_t*>(clientHandle),
+    if (clientHandle && !uv_is_closing(reinterpret_cast<uv_handle_t*>(clientHandle))) {
+        uv_close(reinterpret_cast<uv_handle_t*>(clientHandle), [](uv_handle_t* handle) {
+            delete static_cast<ClientContext*>(handle->data);
+            delete reinterpret_cast<uv_tcp_t*>(handle);
+        });
+    }
+}
+
+void CUVTcpServer::deleteServerHandle(uv_tcp_t* serverHandle)
+{
+    if (serverHandle && !uv_is_closing(reinterpret_cast<uv_handle_t*>(serverHandle))) {
+        uv_close(reinterpret_cast<uv_handle_t*>(serverHandle),
                  [](uv_handle_t* handle) { delete reinterpret_cast<uv_tcp_t*>(handle); });
     }
 }
 
-void CUVTcpServer::deleteTimeoutTimer(uv_timer_t* timeoutTimer)
+void CUVTcpServer::clearShards()
+{
+    for (Shard* shard : m_shards) {
+        delete shard;
+    }
+    m_shards.clear();
+
+    delete m_acceptor;
+    m_acceptor = nullptr;
+}
+
+bool CUVTcpServer::isInShardLoopThread() const
+{
+    if (m_acceptor && m_acceptor->loop->isInLoopThread()) {
+        return true;
+    }
+    for (const Shard* shard : m_shards) {
+        if (shard->loop->isInLoopThread()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 等待各分片所在循环处理完已投递的关闭任务、句柄关闭回调和排队的发送任务，
+// 当前线程是某个分片的循环线程时无法等待，直接返回
+void CUVTcpServer::waitForShards() const
+{
+    if (isInShardLoopThread()) {
+        return;
+    }
+
+    // 排在关闭之后的发送任务找不到客户端，很快执行完毕
+    waitUntilIdle(&CUVTcpServer::hasPendingSends, std::chrono::steady_clock::time_point::max());
+
+    std::vector<Shard*> shards(m_shards);
+    if (m_acceptor) {
+        shards.push_back(m_acceptor);
+    }
+
+    // 句柄关闭回调在本轮循环末尾执行，屏障再经时间轮推迟到之后的循环中完成；
+    // 屏障完成时减少计数后正在唤醒等待者的循环线程也已离开，分片可以随即释放；
+    // 事件循环已停止时屏障任务被丢弃，等待立即返回
+    std::vector<CUVFuture<void>> barriers;
+    barriers.reserve(shards.size());
+    for (Shard* shard : shards) {
+        CUVLoop* loop = shard->loop;
+        CUVPromise<void> promise;
+        barriers.push_back(promise.getFuture());
+        loop->postTask(
+            [loop, promise = std::move(promise)]() mutable {
+                loop->postDelayed(1, [promise = std::move(promise)]() mutable {
+                    promise.setValue();
+                });
+            },
+            CUVLoop::TaskPriority::HIGH);
+    }
+    for (CUVFuture<void>& barrier : barriers) {
+        barrier.wait();
+    }
+}
+
+// 是否有尚未执行的发送任务
+bool CUVTcpServer::hasPendingSends() const
+{
+    for (const Shard* shard : m_shards) {
+        if (shard->pendingSends.load() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 是否有尚未执行的发送任务或尚未完成的写请求
+bool CUVTcpServer::hasPendingWrites() const
+{
+    for (const Shard* shard : m_shards) {
+        if (shard->pendingSends.load() > 0 || shard->pendingWriteBytes.load() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 待执行的发送任务或未完成的写入归零时唤醒waitUntilIdle()中的等待者，没有等待者时不加锁
+void CUVTcpServer::notifyIdle() const
+{
+    if (m_idleWaiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCond.notify_all();
+    }
+}
+
+// 阻塞等待pending返回false，由notifyIdle()唤醒而不是轮询；超过截止时间时返回false
+bool CUVTcpServer::waitUntilIdle(bool (CUVTcpServer::*pending)() const,
+                                 std::chrono::steady_clock::time_point deadline) const
+{
+    auto idle = [this, pending]() { return !(this->*pending)(); };
+
+    // 先登记等待者再检查条件，与先减少计数再检查等待者的notifyIdle()配合不会丢失唤醒
+    m_idleWaiters.fetch_add(1);
+    bool result = true;
+    {
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            m_idleCond.wait(lock, idle);
+        } else {
+            result = m_idleCond.wait_until(lock, deadline, idle);
+        }
+    }
+    m_idleWaiters.fetch_sub(1);
+    return result;
+}
+
+void CUVTcpServer::setListenMode(ListenMode mode, size_t shardCount)
+{
+    if (m_state.load() != ServerState::STOPPED) {
+        return;
+    }
+
+    clearShards();
+    m_listenMode = mode;
+
+    if (mode == ListenMode::SINGLE) {
+        m_shards.push_back(new Shard{this, 0, m_loop, nullptr, {}});
+        return;
+    }
+
+    if (shardCount == 0) {
+        shardCount = m_loopPool->size();
+    }
+    for (size_t i = 0; i < shardCount; ++i) {
+        m_shards.push_back(new Shard{this, i, m_loopPool->getLoop(i), nullptr, {}});
+    }
+
+    // 接收分片只负责accept，不持有客户端
+    if (mode == ListenMode::ACCEPTOR) {
+        m_acceptor = new Shard{this, 0, m_loop, nullptr, {}};
+    }
+}
+
+size_t CUVTcpServer::getShardCount() const
+{
+    return m_shards.size();
+}
+
+std::vector<CUVTcpServer::ShardStats> CUVTcpServer::getShardStats() const
 {
-    if (timeoutTimer && !uv_is_closing(reinterpret_cast<uv_handle_t*>(timeoutTimer))) {
-        uv_timer_stop(timeoutTimer);
-        uv_close(reinterpret_cast<uv_handle_t*>(timeoutTimer),
-                 [](uv_handle_t* handle) { delete reinterpret_cast<uv_timer_t*>(handle); });
+    std::vector<ShardStats> stats;
+    stats.reserve(m_shards.size());
+    for (const Shard* shard : m_shards) {
+        uint64_t handoffs = shard->handoffCount.load(std::memory_order_relaxed);
+        uint64_t latencyNs = shard->handoffLatencyNs.load(std::memory_order_relaxed);
+        stats.push_back(ShardStats{shard->index,
+                                   shard->connectionCount.load(std::memory_order_relaxed),
+                                   handoffs,
+                                   handoffs > 0 ? latencyNs / handoffs / 1000 : 0,
+                                   shard->handoffLatencyMaxNs.load(std::memory_order_relaxed)
+                                       / 1000,
+                                   shard->immediateBytes.load(std::memory_order_relaxed),
+                                   shard->queuedBytes.load(std::memory_order_relaxed)});
     }
+    return stats;
+}
+
+CUVTcpServer::Shard* CUVTcpServer::leastConnectedShard() const
+{
+    Shard* selected = m_shards.front();
+    size_t minConnections = selected->connectionCount.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < m_shards.size() && minConnections > 0; ++i) {
+        size_t connections = m_shards[i]->connectionCount.load(std::memory_order_relaxed);
+        if (connections < minConnections) {
+            minConnections = connections;
+            selected = m_shards[i];
+        }
+    }
+    return selected;
 }
 
 void CUVTcpServer::listen(const std::string& host, int port)
@@ -91,83 +586,302 @@ void CUVTcpServer::listen(const std::string& host, int port)
         return;
     }
 
-    postTask([=]() {
-        // 检查服务器状态
-        if (m_state.load() != ServerState::STOPPED) {
-            if (m_serverStartCallback) {
-                m_serverStartCallback(false, "CUVTcpServer: Server is already running.");
-            }
-            return;
+    // 检查服务器状态
+    ServerState expected = ServerState::STOPPED;
+    if (!m_state.compare_exchange_strong(expected, ServerState::STARTING)) {
+        if (m_serverStartCallback) {
+            m_serverStartCallback(false, "CUVTcpServer: Server is already running.");
         }
+        return;
+    }
 
-        m_state.store(ServerState::STARTING);
-        m_listenAddress.ip = host;
-        m_listenAddress.port = port;
+    m_listenAddress.ip = host;
+    m_listenAddress.port = port;
+    m_startedShards.store(0);
+    for (Shard* shard : m_shards) {
+        shard->startError.clear();
+    }
+    if (m_acceptor) {
+        m_acceptor->startError.clear();
+    }
 
-        // 初始化服务器TCP句柄
-        if (!m_serverHandle) {
-            m_serverHandle = new uv_tcp_t;
-            std::memset(m_serverHandle, 0, sizeof(uv_tcp_t));
-            m_serverHandle->data = this;
+    // ACCEPTOR模式下只有接收分片监听端口
+    if (m_acceptor) {
+        m_pendingShards.store(1);
+        m_acceptor->loop->postTask([this, host, port]() { listenShard(m_acceptor, host, port); },
+                                   CUVLoop::TaskPriority::HIGH);
+        return;
+    }
 
-            if (int result = uv_tcp_init(m_loop->getLoop(), m_serverHandle); result != 0) {
-                delete m_serverHandle;
-                m_serverHandle = nullptr;
-                if (m_serverStartCallback) {
-                    m_serverStartCallback(false,
-                                          "CUVTcpServer: Failed to initialize TCP handle: "
-                                              + std::string(uv_strerror(result)));
-                }
-                return;
-            }
-        }
+    m_pendingShards.store(m_shards.size());
+    for (Shard* shard : m_shards) {
+        shard->loop->postTask([this, shard, host, port]() { listenShard(shard, host, port); },
+                              CUVLoop::TaskPriority::HIGH);
+    }
+}
 
-        // 绑定地址
-        struct sockaddr_in addr;
-        int result = uv_ip4_addr(host.c_str(), port, &addr);
-        if (result != 0) {
-            m_state.store(ServerState::STOPPED);
-            if (m_serverStartCallback) {
-                m_serverStartCallback(false,
-                                      "CUVTcpServer: Failed to parse address: "
-                                          + std::string(uv_strerror(result)));
-            }
-            return;
-        }
+void CUVTcpServer::listenShard(Shard* shard, const std::string& host, int port)
+{
+    if (m_state.load() != ServerState::STARTING) {
+        shard->startError = (m_listenMode != ListenMode::REUSEPORT
+                                 ? std::string("CUVTcpServer: ")
+                                 : "CUVTcpServer: Shard " + std::to_string(shard->index) + ": ")
+                            + "Server stopped before listening.";
+        finishShardStart(false);
+        return;
+    }
 
-        result = uv_tcp_bind(m_serverHandle, reinterpret_cast<const struct sockaddr*>(&addr), 0);
-        if (result != 0) {
-            m_state.store(ServerState::STOPPED);
-            if (m_serverStartCallback) {
-                m_serverStartCallback(false,
-                                      "CUVTcpServer: Failed to bind address: "
-                                          + std::string(uv_strerror(result)));
-            }
+    // 初始化服务器TCP句柄
+    shard->serverHandle = new uv_tcp_t;
+    std::memset(shard->serverHandle, 0, sizeof(uv_tcp_t));
+
+    if (int result = uv_tcp_init(shard->loop->getLoop(), shard->serverHandle); result != 0) {
+        delete shard->serverHandle;
+        shard->serverHandle = nullptr;
+        failShardStart(shard, "Failed to initialize TCP handle: ", result);
+        return;
+    }
+    shard->serverHandle->data = shard;
+
+    // REUSEPORT模式下预先创建带SO_REUSEPORT选项的套接字
+    if (m_listenMode == ListenMode::REUSEPORT) {
+        if (int result = openReusePortSocket(shard->serverHandle); result != 0) {
+            failShardStart(shard, "Failed to open SO_REUSEPORT socket: ", result);
             return;
         }
+    }
+
+    // 绑定地址
+    struct sockaddr_in addr;
+    int result = uv_ip4_addr(host.c_str(), port, &addr);
+    if (result != 0) {
+        failShardStart(shard, "Failed to parse address: ", result);
+        return;
+    }
+
+    result = uv_tcp_bind(shard->serverHandle, reinterpret_cast<const struct sockaddr*>(&addr), 0);
+    if (result != 0) {
+        failShardStart(shard, "Failed to bind address: ", result);
+        return;
+    }
+
+    // 经IPC管道移交时，等各工作分片都连上移交管道之后再开始监听
+    if (shard == m_acceptor && kHandOffOverPipe) {
+        openHandOffPipes(shard);
+        return;
+    }
+
+    startAccepting(shard);
+}
 
-        // 开始监听连接
-        result = uv_listen(reinterpret_cast<uv_stream_t*>(m_serverHandle),
+// 在分片所在循环中开始监听连接并完成该分片的启动
+void CUVTcpServer::startAccepting(Shard* shard)
+{
+    int result = uv_listen(reinterpret_cast<uv_stream_t*>(shard->serverHandle),
                            (int) m_maxConnections,
                            onNewConnection);
+    if (result != 0) {
+        failShardStart(shard, "Failed to start listening: ", result);
+        return;
+    }
+
+    finishShardStart(true);
+}
+
+// 分片启动失败时的统一处理，失败原因由最后完成启动的分片一起报告
+void CUVTcpServer::failShardStart(Shard* shard, const std::string& reason, int result)
+{
+    const std::string shardPrefix = m_listenMode != ListenMode::REUSEPORT
+                                        ? std::string("CUVTcpServer: ")
+                                        : "CUVTcpServer: Shard " + std::to_string(shard->index)
+                                              + ": ";
+
+    deleteServerHandle(shard->serverHandle);
+    shard->serverHandle = nullptr;
+    closeHandOffPipes(shard);
+    shard->startError = shardPrefix + reason + std::string(uv_strerror(result));
+    finishShardStart(false);
+}
+
+// 在接收分片所在循环中为每个工作分片打开一条移交管道，由工作分片连接过来
+void CUVTcpServer::openHandOffPipes(Shard* acceptor)
+{
+    acceptor->handoffListeners.assign(m_shards.size(), nullptr);
+    acceptor->handoffSenders.assign(m_shards.size(), nullptr);
+
+    for (Shard* worker : m_shards) {
+        uv_pipe_t* listener = new uv_pipe_t;
+        std::memset(listener, 0, sizeof(uv_pipe_t));
+
+        int result = uv_pipe_init(acceptor->loop->getLoop(), listener, 0);
         if (result != 0) {
-            m_state.store(ServerState::STOPPED);
-            if (m_serverStartCallback) {
-                m_serverStartCallback(false,
-                                      "CUVTcpServer: Failed to start listening: "
-                                          + std::string(uv_strerror(result)));
-            }
+            delete listener;
+            failShardStart(acceptor, "Failed to initialize hand-off pipe: ", result);
             return;
         }
+        listener->data = acceptor;
+        acceptor->handoffListeners[worker->index] = listener;
 
-        if (m_serverStartCallback) {
-            m_serverStartCallback(true,
-                                  "CUVTcpServer: Server started at " + host + ":"
-                                      + std::to_string(port));
+        std::string name = handOffPipeName(this, worker->index);
+        result = uv_pipe_bind(listener, name.c_str());
+        if (result == 0) {
+            result = uv_listen(reinterpret_cast<uv_stream_t*>(listener), 1, onHandOffConnection);
+        }
+        if (result != 0) {
+            failShardStart(acceptor, "Failed to open hand-off pipe: ", result);
+            return;
         }
 
-        m_state.store(ServerState::RUNNING);
-    });
+        worker->loop->postTask([worker, name]() { connectHandOffPipe(worker, name); },
+                               CUVLoop::TaskPriority::HIGH);
+    }
+}
+
+// 在工作分片所在循环中连接移交管道
+void CUVTcpServer::connectHandOffPipe(Shard* worker, const std::string& name)
+{
+    // 上一次启动失败时可能留下未关闭的管道
+    deletePipeHandle(worker->handoffReceiver);
+    worker->handoffReceiver = nullptr;
+    worker->handoffPending.clear();
+
+    uv_pipe_t* receiver = new uv_pipe_t;
+    std::memset(receiver, 0, sizeof(uv_pipe_t));
+
+    if (int result = uv_pipe_init(worker->loop->getLoop(), receiver, 1); result != 0) {
+        delete receiver;
+        failHandOffPipe(worker, result);
+        return;
+    }
+    receiver->data = worker;
+    worker->handoffReceiver = receiver;
+
+    uv_connect_t* req = new uv_connect_t;
+    req->data = worker;
+    uv_pipe_connect(req, receiver, name.c_str(), onHandOffConnect);
+}
+
+// 工作分片连上移交管道后开始读取
+void CUVTcpServer::onHandOffConnect(uv_connect_t* req, int status)
+{
+    Shard* worker = static_cast<Shard*>(req->data);
+    delete req;
+
+    // 管道已随分片关闭
+    if (status == UV_ECANCELED) {
+        return;
+    }
+
+    if (status == 0) {
+        status = uv_read_start(reinterpret_cast<uv_stream_t*>(worker->handoffReceiver),
+                               onHandOffAlloc,
+                               onHandOffRead);
+    }
+    if (status != 0) {
+        failHandOffPipe(worker, status);
+    }
+}
+
+// 工作分片无法建立移交管道时，通知接收分片让启动失败
+void CUVTcpServer::failHandOffPipe(Shard* worker, int status)
+{
+    Shard* acceptor = worker->server->m_acceptor;
+    acceptor->loop->postTask(
+        [acceptor, status]() {
+            // 移交管道已全部建立或启动已经失败时不再处理
+            if (acceptor->serverHandle && !acceptor->handoffListeners.empty()) {
+                acceptor->server->failShardStart(acceptor,
+                                                 "Failed to connect hand-off pipe: ",
+                                                 status);
+            }
+        },
+        CUVLoop::TaskPriority::HIGH);
+}
+
+// 接收分片接受工作分片的移交管道连接，全部连上之后开始监听端口
+void CUVTcpServer::onHandOffConnection(uv_stream_t* listener, int status)
+{
+    Shard* acceptor = static_cast<Shard*>(listener->data);
+    std::vector<uv_pipe_t*>& listeners = acceptor->handoffListeners;
+    size_t index = std::find(listeners.begin(), listeners.end(),
+                             reinterpret_cast<uv_pipe_t*>(listener))
+                   - listeners.begin();
+
+    if (status < 0) {
+        acceptor->server->failShardStart(acceptor, "Failed to accept hand-off pipe: ", status);
+        return;
+    }
+
+    uv_pipe_t* sender = new uv_pipe_t;
+    std::memset(sender, 0, sizeof(uv_pipe_t));
+
+    int result = uv_pipe_init(acceptor->loop->getLoop(), sender, 1);
+    if (result != 0) {
+        delete sender;
+    } else if ((result = uv_accept(listener, reinterpret_cast<uv_stream_t*>(sender))) != 0) {
+        deletePipeHandle(sender);
+    }
+    if (result != 0) {
+        acceptor->server->failShardStart(acceptor, "Failed to accept hand-off pipe: ", result);
+        return;
+    }
+
+    // 拒绝其他进程的连接，监听管道保持打开等待工作分片连上
+    if (!isHandOffPeer(sender)) {
+        deletePipeHandle(sender);
+        return;
+    }
+    sender->data = acceptor;
+    acceptor->handoffSenders[index] = sender;
+
+    // 监听管道只用于建立这一条连接
+    deletePipeHandle(listeners[index]);
+    listeners[index] = nullptr;
+
+    if (std::any_of(listeners.begin(), listeners.end(), [](uv_pipe_t* pipe) { return pipe; })) {
+        return;
+    }
+    listeners.clear();
+    acceptor->server->startAccepting(acceptor);
+}
+
+// 最后一个完成启动的分片决定服务器状态，并汇总各分片的结果只调用一次启动回调
+void CUVTcpServer::finishShardStart(bool success)
+{
+    if (success) {
+        m_startedShards.fetch_add(1);
+    }
+
+    if (m_pendingShards.fetch_sub(1) != 1) {
+        return;
+    }
+
+    size_t startedShards = m_startedShards.load();
+    ServerState expected = ServerState::STARTING;
+    m_state.compare_exchange_strong(expected,
+                                    startedShards > 0 ? ServerState::RUNNING
+                                                      : ServerState::STOPPED);
+    if (!m_serverStartCallback) {
+        return;
+    }
+
+    // 其余分片的启动任务都已执行完毕，失败原因可以直接读取
+    std::vector<Shard*> shards = m_acceptor ? std::vector<Shard*>{m_acceptor} : m_shards;
+    std::string info;
+    if (startedShards > 0) {
+        info = "CUVTcpServer: Server started at " + m_listenAddress.toString();
+        if (m_listenMode == ListenMode::REUSEPORT) {
+            info += " on " + std::to_string(startedShards) + "/" + std::to_string(shards.size())
+                    + " shards";
+        }
+        info += ".";
+    }
+    for (const Shard* shard : shards) {
+        if (!shard->startError.empty()) {
+            info += (info.empty() ? "" : " ") + shard->startError;
+        }
+    }
+    m_serverStartCallback(startedShards > 0, info);
 }
 
 void CUVTcpServer::stop()
@@ -187,71 +901,419 @@ void CUVTcpServer::stop()
     };
     m_state.store(ServerState::STOPPING);
 
-    auto serverHandle = m_serverHandle;
-    m_serverHandle = nullptr;
+    closeShards();
+    waitForShards();
 
-    auto clients_copy = m_clients;
-    m_clients.clear();
+    m_state.store(ServerState::STOPPED);
 
-    postTask([serverHandle, clients = std::move(clients_copy)]() {
-        // 关闭服务器TCP句柄
-        if (serverHandle && !uv_is_closing(reinterpret_cast<uv_handle_t*>(serverHandle))) {
-            uv_close(reinterpret_cast<uv_handle_t*>(serverHandle),
-                     [](uv_handle_t* handle) { delete reinterpret_cast<uv_tcp_t*>(handle); });
-        }
+    if (m_serverStopCallback) {
+        m_serverStopCallback("CUVTcpServer: Server stopped.");
+    }
+}
 
-        // 关闭所有客户端连接
-        for (auto& pair : clients) {
-            // 关闭客户端句柄
-            deleteClientHandle(pair.second.handle);
-            // 关闭超时定时器
-            deleteTimeoutTimer(pair.second.timeoutTimer);
-        }
-    });
+CUVTcpServer::DrainReport CUVTcpServer::drain(uint64_t timeoutMs)
+{
+    DrainReport report{false, 0, 0, 0, 0};
+
+    ServerState expected = ServerState::RUNNING;
+    if (!isLoopValid() || !m_state.compare_exchange_strong(expected, ServerState::STOPPING)) {
+        return report;
+    }
+
+    uint64_t startTime = uv_hrtime();
+    uint64_t flushedBefore = 0;
+    uint64_t droppedBefore = 0;
+    for (const Shard* shard : m_shards) {
+        flushedBefore += shard->flushedBytes.load();
+        droppedBefore += shard->droppedBytes.load();
+    }
+
+    // 停止接受新连接，已建立的连接继续收发
+    std::vector<Shard*> shards(m_shards);
+    if (m_acceptor) {
+        shards.push_back(m_acceptor);
+    }
+    bool inLoopThread = false;
+    for (Shard* shard : shards) {
+        inLoopThread = inLoopThread || shard->loop->isInLoopThread();
+        shard->loop->postTask(
+            [shard]() {
+                deleteServerHandle(shard->serverHandle);
+                shard->serverHandle = nullptr;
+            },
+            CUVLoop::TaskPriority::HIGH);
+    }
+
+    // 等待已投递的发送任务和写请求完成，在事件循环线程中等待会阻塞该循环，因此不等待
+    if (!inLoopThread) {
+        waitUntilIdle(&CUVTcpServer::hasPendingWrites,
+                      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs));
+    }
+    report.completed = !hasPendingWrites();
+
+    // 关闭全部连接，仍在写队列中的请求以UV_ECANCELED完成并计为丢弃
+    for (const Shard* shard : m_shards) {
+        report.closedConnections += shard->connectionCount.load();
+    }
+    closeShards();
+    waitForShards();
+
+    for (const Shard* shard : m_shards) {
+        report.flushedBytes += shard->flushedBytes.load();
+        report.droppedBytes += shard->droppedBytes.load();
+    }
+    report.flushedBytes -= flushedBefore;
+    report.droppedBytes -= droppedBefore;
+    report.elapsedMs = (uv_hrtime() - startTime) / 1000000;
 
     m_state.store(ServerState::STOPPED);
 
     if (m_serverStopCallback) {
-        m_serverStopCallback("CUVTcpServer: Server stopped.");
+        m_serverStopCallback("CUVTcpServer: Server drained.");
+    }
+    return report;
+}
+
+// 向各分片投递关闭任务
+void CUVTcpServer::closeShards()
+{
+    if (m_acceptor) {
+        Shard* acceptor = m_acceptor;
+        acceptor->loop->postTask([acceptor]() { closeShard(acceptor); }, CUVLoop::TaskPriority::HIGH);
+    }
+
+    for (Shard* shard : m_shards) {
+        shard->loop->postTask([shard]() { closeShard(shard); }, CUVLoop::TaskPriority::HIGH);
+    }
+}
+
+// 在分片所在循环中关闭移交管道，已收到但尚未登记的移交连接直接关闭
+void CUVTcpServer::closeHandOffPipes(Shard* shard)
+{
+    for (uv_pipe_t* pipe : shard->handoffListeners) {
+        deletePipeHandle(pipe);
+    }
+    for (uv_pipe_t* pipe : shard->handoffSenders) {
+        deletePipeHandle(pipe);
+    }
+    shard->handoffListeners.clear();
+    shard->handoffSenders.clear();
+
+    uv_pipe_t* receiver = shard->handoffReceiver;
+    if (!receiver) {
+        return;
+    }
+
+    while (uv_pipe_pending_type(receiver) == UV_TCP) {
+        uv_tcp_t* clientHandle = new uv_tcp_t;
+        std::memset(clientHandle, 0, sizeof(uv_tcp_t));
+        if (uv_tcp_init(shard->loop->getLoop(), clientHandle) != 0) {
+            delete clientHandle;
+            break;
+        }
+        uv_accept(reinterpret_cast<uv_stream_t*>(receiver),
+                  reinterpret_cast<uv_stream_t*>(clientHandle));
+        deleteClientHandle(clientHandle);
+        shard->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    deletePipeHandle(receiver);
+    shard->handoffReceiver = nullptr;
+    shard->handoffPending.clear();
+}
+
+// 在分片所在循环中关闭监听句柄和全部客户端连接
+void CUVTcpServer::closeShard(Shard* shard)
+{
+    // 关闭服务器TCP句柄和移交管道
+    deleteServerHandle(shard->serverHandle);
+    shard->serverHandle = nullptr;
+    closeHandOffPipes(shard);
+
+    // 先清空客户端表，之后的发送回调中再发送时找不到客户端，不会重新排队
+    std::vector<ClientContext*> clients(shard->clients.begin(), shard->clients.end());
+    shard->clients.clear();
+    shard->addresses.clear();
+
+    // 关闭所有客户端连接
+    for (ClientContext* clientCtx : clients) {
+        // 取消接收超时定时器
+        shard->loop->getTimingWheel()->cancel(&clientCtx->timeoutTimer);
+        // 关闭客户端句柄
+        deleteClientHandle(clientCtx->clientHandle);
+        shard->loop->removeConnection();
+        shard->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 丢弃尚未写出的消息，上下文在句柄关闭回调中才释放
+    for (ClientContext* clientCtx : clients) {
+        discardOutbound(clientCtx);
     }
 }
 
 void CUVTcpServer::send(const Address& clientAddr, const std::string& data)
 {
-    postTask([this, clientAddr, data]() {
+    send(clientAddr, std::string(data));
+}
+
+void CUVTcpServer::send(const Address& clientAddr, std::string&& data)
+{
+    // 回调中传入的地址带有连接ID，直接按ID发送；手工构造的地址到各分片中查找
+    if (clientAddr.connectionId == 0) {
+        sendByAddress(clientAddr, std::move(data));
+        return;
+    }
+
+    Address target = clientAddr;
+    Shard* shard = shardOf(target.connectionId);
+    if (!shard) {
+        if (m_sendCallback) {
+            m_sendCallback(clientAddr, false, "CUVTcpServer: Client not found.");
+        }
+        return;
+    }
+    target.shard = shard->index;
+
+    SendTicket ticket(shard, data.size(), target);
+    // 服务器指针和地址都从凭据中取得，任务不超出CUVTask的内联存储
+    auto task = [ticket = std::move(ticket), data = std::move(data)]() mutable {
+        ticket.execute();
+
         // 查找客户端
-        auto it = m_clients.find(clientAddr);
-        if (it == m_clients.end()) {
-            if (m_sendCallback) {
-                m_sendCallback(clientAddr, false, "CUVTcpServer: Client not found.");
+        CUVTcpServer* server = ticket.shard()->server;
+        ClientContext* clientCtx = findClient(ticket.shard(), ticket.connectionId());
+        if (!clientCtx) {
+            if (server->m_sendCallback) {
+                server->m_sendCallback(ticket.clientAddr(),
+                                       false,
+                                       "CUVTcpServer: Client not found.");
             }
             return;
         }
+        server->writeClient(clientCtx, std::move(data), ticket);
+    };
+    static_assert(sizeof(task) <= CUVTask::kInlineSize,
+                  "send task must fit in CUVTask inline storage");
 
-        uv_tcp_t* clientHandle = it->second.handle;
-        ClientContext* clientCtx = static_cast<ClientContext*>(clientHandle->data);
+    // 在分片所在循环线程中（如在接收回调中回复）直接放入发送队列，不经过任务队列
+    if (shard->loop->isInLoopThread()) {
+        task();
+        return;
+    }
 
-        uv_write_t* writeReq = new uv_write_t;
-        writeReq->data = clientCtx;
+    // 任务被拒绝时随即销毁，由凭据报告发送失败
+    shard->loop->postTask(std::move(task));
+}
 
-        uv_buf_t buf = uv_buf_init(const_cast<char*>(data.data()), static_cast<ULONG>(data.size()));
+void CUVTcpServer::sendByAddress(const Address& clientAddr, std::string&& data)
+{
+    if (m_shards.empty()) {
+        if (m_sendCallback) {
+            m_sendCallback(clientAddr, false, "CUVTcpServer: Client not found.");
+        }
+        return;
+    }
 
-        int result = uv_write(writeReq,
-                              reinterpret_cast<uv_stream_t*>(clientHandle),
-                              &buf,
-                              1,
-                              onSend);
-        if (result != 0) {
-            delete writeReq;
-            if (m_sendCallback) {
-                m_sendCallback(clientAddr,
-                               false,
-                               "CUVTcpServer: Failed to send data: "
-                                   + std::string(uv_strerror(result)));
+    auto lookup = std::make_shared<AddressLookup>(clientAddr, std::move(data), m_shards.size());
+    for (Shard* shard : m_shards) {
+        auto task = [ticket = LookupTicket(shard, lookup)]() mutable {
+            ticket.execute();
+
+            // 只有一个分片能取得数据，取得后在本循环线程中按连接ID直接放入发送队列
+            const std::shared_ptr<AddressLookup>& lookup = ticket.lookup();
+            ConnectionId id = findConnection(ticket.shard(), lookup->clientAddr);
+            if (id != 0 && !lookup->claimed.exchange(true)) {
+                Address target = lookup->clientAddr;
+                target.connectionId = id;
+                ticket.shard()->server->send(target, std::move(lookup->data));
             }
-            return;
+        };
+        static_assert(sizeof(task) <= CUVTask::kInlineSize,
+                      "lookup task must fit in CUVTask inline storage");
+
+        if (shard->loop->isInLoopThread()) {
+            task();
+            continue;
         }
-    });
+        // 任务被拒绝时随即销毁，由凭据记为丢弃
+        shard->loop->postTask(std::move(task));
+    }
+}
+
+void CUVTcpServer::send(ConnectionId id, const std::string& data)
+{
+    send(id, std::string(data));
+}
+
+void CUVTcpServer::send(ConnectionId id, std::string&& data)
+{
+    send(Address{"", 0, 0, id}, std::move(data));
+}
+
+// 放入客户端的发送队列，由循环末尾的onFlush与同一轮的其他消息合并为一次写请求
+void CUVTcpServer::writeClient(ClientContext* clientCtx, std::string&& data, SendTicket& ticket)
+{
+    clientCtx->outboundBytes += data.size();
+    clientCtx->outbound.push_back(std::move(data));
+    ticket.commit();
+    clientCtx->shard->loop->scheduleFlush(&clientCtx->flushHook);
+}
+
+// 把发送队列中的全部消息作为一个缓冲区数组写出：先用uv_try_write直接写入套接字，
+// 全部写完时不创建写请求，发送回调在本轮循环中调用；只有未写完的部分交给uv_write排队
+void CUVTcpServer::onFlush(CUVLoop::FlushHook* hook)
+{
+    ClientContext* clientCtx = static_cast<ClientContext*>(hook->data);
+    Shard* shard = clientCtx->shard;
+    uv_stream_t* stream = reinterpret_cast<uv_stream_t*>(clientCtx->clientHandle);
+    size_t count = clientCtx->outbound.size();
+    uint64_t bytes = clientCtx->outboundBytes;
+
+    std::vector<uv_buf_t>& bufs = shard->writeBufs;
+    bufs.clear();
+    for (std::string& message : clientCtx->outbound) {
+        bufs.push_back(uv_buf_init(const_cast<char*>(message.data()),
+                                   static_cast<unsigned int>(message.size())));
+    }
+
+    // libuv写队列不为空或套接字缓冲区已满时返回UV_EAGAIN，句柄不支持直接写入时返回UV_ENOSYS，
+    // 此时全部交给uv_write；其他错误（连接已重置或关闭）整批失败
+    int written = uv_try_write(stream, bufs.data(), static_cast<unsigned int>(bufs.size()));
+    if (written == UV_EAGAIN || written == UV_ENOSYS) {
+        written = 0;
+    } else if (written < 0) {
+        clientCtx->outbound.clear();
+        clientCtx->outboundBytes = 0;
+        finishWrites(clientCtx, count, bytes, written);
+        return;
+    }
+    shard->immediateBytes.fetch_add(written, std::memory_order_relaxed);
+
+    // 全部写完，先清空发送队列，发送回调中可以继续发送
+    if (static_cast<uint64_t>(written) == bytes) {
+        clientCtx->outbound.clear();
+        clientCtx->outboundBytes = 0;
+        finishWrites(clientCtx, count, bytes, 0);
+        return;
+    }
+
+    // 跳过已写出的部分，剩余部分排队
+    size_t first = 0;
+    size_t offset = static_cast<size_t>(written);
+    while (offset >= bufs[first].len) {
+        offset -= bufs[first].len;
+        ++first;
+    }
+    bufs[first].base += offset;
+    bufs[first].len -= static_cast<decltype(uv_buf_t::len)>(offset);
+    shard->queuedBytes.fetch_add(bytes - written, std::memory_order_relaxed);
+
+    WriteBatch* batch = new WriteBatch{{}, clientCtx, {}, bytes};
+    batch->req.data = batch;
+    batch->messages.swap(clientCtx->outbound);
+    clientCtx->outboundBytes = 0;
+
+    // 连接已在关闭中时uv_write直接返回错误
+    int result = uv_write(&batch->req,
+                          stream,
+                          bufs.data() + first,
+                          static_cast<unsigned int>(bufs.size() - first),
+                          onSend);
+    if (result != 0) {
+        finishWrites(clientCtx, count, bytes, result);
+        delete batch;
+    }
+}
+
+void CUVTcpServer::finishWrites(ClientContext* clientCtx, size_t count, uint64_t bytes, int status)
+{
+    CUVTcpServer* tcpServer = clientCtx->server;
+
+    // 先计入写出或丢弃的字节数，再减少未完成字节数，排空等待结束时统计已经完整
+    Shard* shard = clientCtx->shard;
+    (status == 0 ? shard->flushedBytes : shard->droppedBytes).fetch_add(bytes);
+    if (shard->pendingWriteBytes.fetch_sub(bytes) == bytes) {
+        tcpServer->notifyIdle();
+    }
+
+    if (!tcpServer->m_sendCallback) {
+        return;
+    }
+    std::string error;
+    if (status != 0) {
+        error = "CUVTcpServer: Failed to send data: " + std::string(uv_strerror(status));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        tcpServer->m_sendCallback(clientCtx->addr, status == 0, error);
+    }
+}
+
+// 客户端必须已从客户端表中移除：先取出发送队列并取消回调节点，最后才调用发送回调，
+// 回调中的发送因找不到客户端而失败，不会在即将释放的上下文上重新排队
+void CUVTcpServer::discardOutbound(ClientContext* clientCtx)
+{
+    clientCtx->shard->loop->cancelFlush(&clientCtx->flushHook);
+
+    std::vector<std::string> outbound;
+    outbound.swap(clientCtx->outbound);
+    uint64_t bytes = std::exchange(clientCtx->outboundBytes, 0);
+    if (!outbound.empty()) {
+        finishWrites(clientCtx, outbound.size(), bytes, UV_ECANCELED);
+    }
+}
+
+// 由连接ID的高位得到分片，不检查连接是否仍然存在
+CUVTcpServer::Shard* CUVTcpServer::shardOf(uint64_t connectionId) const
+{
+    size_t index = static_cast<size_t>(connectionId >> kConnectionShardShift);
+    if (connectionId == 0 || index >= m_shards.size()) {
+        return nullptr;
+    }
+    return m_shards[index];
+}
+
+// 正在关闭的连接视为不存在，发送回调中重发的消息不会在关闭中的连接上反复排队
+CUVTcpServer::ClientContext* CUVTcpServer::findClient(Shard* shard, ConnectionId id)
+{
+    ClientContext** clientCtx = shard->clients.find(id & CUVSlotMap<ClientContext*>::kKeyMask);
+    if (!clientCtx || uv_is_closing(reinterpret_cast<uv_handle_t*>((*clientCtx)->clientHandle))) {
+        return nullptr;
+    }
+    return *clientCtx;
+}
+
+void CUVTcpServer::removeAddress(Shard* shard, const ClientContext* clientCtx)
+{
+    // 取不到对端地址的连接共用空地址，索引可能已指向其他连接
+    auto it = shard->addresses.find(clientCtx->addr);
+    if (it != shard->addresses.end() && it->second == clientCtx->id) {
+        shard->addresses.erase(it);
+    }
+}
+
+// 没有连接ID的地址（手工构造的地址）经分片的地址索引得到连接ID，找不到时返回0
+CUVTcpServer::ConnectionId CUVTcpServer::findConnection(Shard* shard, const Address& clientAddr)
+{
+    auto it = shard->addresses.find(clientAddr);
+    return it != shard->addresses.end() ? it->second : 0;
+}
+
+Address CUVTcpServer::getClientAddress(ConnectionId id) const
+{
+    Shard* shard = shardOf(id);
+    if (!shard) {
+        return Address();
+    }
+
+    auto lookup = [shard, id]() {
+        ClientContext* clientCtx = findClient(shard, id);
+        return clientCtx ? clientCtx->addr : Address();
+    };
+    if (shard->loop->isInLoopThread()) {
+        return lookup();
+    }
+    // 查找任务被丢弃（事件循环已停止）时视为找不到客户端
+    return shard->loop->submit(lookup, CUVLoop::TaskPriority::HIGH).get().value_or(Address());
 }
 
 CUVTcpServer::ServerState CUVTcpServer::getState() const
@@ -265,7 +1327,7 @@ void CUVTcpServer::setReceiveTimeoutInterval(int intervalMs)
         return;
     }
 
-    postTask([this, intervalMs]() { m_receiveTimeoutInterval = intervalMs; });
+    m_receiveTimeoutInterval.store(intervalMs);
 }
 
 // ======= 回调设置实现 =======
@@ -287,12 +1349,28 @@ void CUVTcpServer::setConnectCallback(ClientConnectCallback&& callback)
 
 void CUVTcpServer::setDisconnectCallback(ClientDisconnectCallback&& callback)
 {
-    m_clientDisconnectCallback = std::move(callback);
+    m_clientDisconnectCallback
+        = std::make_shared<const ClientDisconnectCallback>(std::move(callback));
 }
 
 void CUVTcpServer::setReceiveCallback(ClientReceiveCallback&& callback)
 {
-    m_clientReceiveCallback = std::move(callback);
+    m_clientReceiveCallback = std::make_shared<const ClientReceiveCallback>(std::move(callback));
+}
+
+void CUVTcpServer::setDataCallback(ClientDataCallback&& callback)
+{
+    m_clientDataCallback = std::make_shared<const ClientDataCallback>(std::move(callback));
+}
+
+void CUVTcpServer::setBufferCallback(ClientBufferCallback&& callback)
+{
+    m_clientBufferCallback = std::make_shared<const ClientBufferCallback>(std::move(callback));
+}
+
+void CUVTcpServer::setReceiveDispatcher(CUVWorkerPool* pool)
+{
+    m_receiveDispatcher.store(pool);
 }
 
 void CUVTcpServer::setSendCallback(SendCallback&& callback)
@@ -310,11 +1388,12 @@ void CUVTcpServer::setReceiveTimeoutCallback(ReceiveTimeoutCallback&& callback)
 // 新连接回调处理
 void CUVTcpServer::onNewConnection(uv_stream_t* server, int status)
 {
-    CUVTcpServer* tcpServer = static_cast<CUVTcpServer*>(server->data);
+    Shard* shard = static_cast<Shard*>(server->data);
+    CUVTcpServer* tcpServer = shard->server;
 
     if (status < 0) {
         if (tcpServer->m_clientConnectCallback) {
-            tcpServer->m_clientConnectCallback(Address{"", 0}, // 无效地址
+            tcpServer->m_clientConnectCallback(Address{"", 0, shard->index}, // 无效地址
                                                false,
                                                "CUVTcpServer: New connection error: "
                                                    + std::string(uv_strerror(status)));
@@ -326,12 +1405,12 @@ void CUVTcpServer::onNewConnection(uv_stream_t* server, int status)
     uv_tcp_t* clientHandle = new uv_tcp_t;
     std::memset(clientHandle, 0, sizeof(uv_tcp_t));
 
-    if (int result = uv_tcp_init(tcpServer->m_loop->getLoop(), clientHandle); result != 0) {
+    if (int result = uv_tcp_init(shard->loop->getLoop(), clientHandle); result != 0) {
         delete clientHandle;
 
         if (tcpServer->m_clientConnectCallback) {
             tcpServer
-                ->m_clientConnectCallback(Address{"", 0}, // 无效地址
+                ->m_clientConnectCallback(Address{"", 0, shard->index}, // 无效地址
                                           false,
                                           "CUVTcpServer: Failed to initialize client TCP handle: "
                                               + std::string(uv_strerror(result)));
@@ -341,88 +1420,263 @@ void CUVTcpServer::onNewConnection(uv_stream_t* server, int status)
 
     // 接受新连接
     if (uv_accept(server, reinterpret_cast<uv_stream_t*>(clientHandle)) == 0) {
-        // 获取客户端地址信息
-        Address address = getAddress(clientHandle);
+        if (shard == tcpServer->m_acceptor) {
+            handOffClient(shard, clientHandle);
+        } else {
+            shard->connectionCount.fetch_add(1, std::memory_order_relaxed);
+            registerClient(shard, clientHandle);
+        }
+    } else {
+        if (tcpServer->m_clientConnectCallback) {
+            tcpServer->m_clientConnectCallback(Address{"", 0, shard->index}, // 无效地址
+                                               false,
+                                               "CUVTcpServer: Failed to accept new connection.");
+        }
 
-        // 检查是否重复连接
-        if (tcpServer->m_clients.find(address) != tcpServer->m_clients.end()) {
-            if (tcpServer->m_clientConnectCallback) {
-                tcpServer->m_clientConnectCallback(address,
-                                                   false,
-                                                   "CUVTcpServer: Duplicate client connection.");
-            };
+        deleteClientHandle(clientHandle);
+    }
+}
 
-            deleteClientHandle(clientHandle);
-            return;
+// 将接收分片上已接受的连接移交给连接数最少的工作分片
+void CUVTcpServer::handOffClient(Shard* acceptor, uv_tcp_t* clientHandle)
+{
+    CUVTcpServer* tcpServer = acceptor->server;
+    uint64_t acceptTime = uv_hrtime();
+
+    // 经IPC管道把句柄连同接受时间戳发给工作分片，写完成后再关闭接收循环上的句柄
+    if (kHandOffOverPipe) {
+        Shard* worker = tcpServer->leastConnectedShard();
+        worker->connectionCount.fetch_add(1, std::memory_order_relaxed);
+
+        HandOffRequest* request = new HandOffRequest{{}, clientHandle, worker, acceptTime};
+        request->req.data = request;
+        uv_buf_t buf = uv_buf_init(reinterpret_cast<char*>(&request->acceptTime),
+                                   sizeof(request->acceptTime));
+        int result = uv_write2(&request->req,
+                               reinterpret_cast<uv_stream_t*>(
+                                   acceptor->handoffSenders[worker->index]),
+                               &buf,
+                               1,
+                               reinterpret_cast<uv_stream_t*>(clientHandle),
+                               onHandOffWrite);
+        if (result != 0) {
+            onHandOffWrite(&request->req, result);
         }
+        return;
+    }
 
-        // 调用外部新连接回调
+    // 复制套接字后关闭接收循环上的句柄，由工作循环重新打开
+    uv_os_sock_t sock{};
+    int result = duplicateSocket(clientHandle, &sock);
+    deleteClientHandle(clientHandle);
+    if (result != 0) {
         if (tcpServer->m_clientConnectCallback) {
-            tcpServer->m_clientConnectCallback(address, true, "");
-        }
-
-        uv_timer_t* timeoutTimer = nullptr;
-        if (tcpServer->m_receiveTimeoutInterval > 0) {
-            // 初始化接收超时定时器
-            timeoutTimer = new uv_timer_t;
-            std::memset(timeoutTimer, 0, sizeof(uv_timer_t));
-
-            if (int result = uv_timer_init(tcpServer->m_loop->getLoop(), timeoutTimer);
-                result != 0) {
-                delete timeoutTimer;
-                timeoutTimer = nullptr;
-
-                deleteClientHandle(clientHandle);
-
-                if (tcpServer->m_clientConnectCallback) {
-                    tcpServer->m_clientConnectCallback(
-                        address,
-                        false,
-                        "CUVTcpServer: Failed to initialize receive timeout timer: "
-                            + std::string(uv_strerror(result)));
-                }
-                return;
-            }
+            tcpServer->m_clientConnectCallback(Address{"", 0, 0}, // 无效地址
+                                               false,
+                                               "CUVTcpServer: Failed to hand off connection: "
+                                                   + std::string(uv_strerror(result)));
         }
+        return;
+    }
+
+    Shard* worker = tcpServer->leastConnectedShard();
+    worker->connectionCount.fetch_add(1, std::memory_order_relaxed);
+    worker->loop->postTask([worker, sock, acceptTime]() { adoptClient(worker, sock, acceptTime); },
+                           CUVLoop::TaskPriority::HIGH);
+}
+
+// 移交写完成（或同步失败）后关闭接收循环上的句柄
+void CUVTcpServer::onHandOffWrite(uv_write_t* req, int status)
+{
+    HandOffRequest* request = static_cast<HandOffRequest*>(req->data);
+    Shard* worker = request->worker;
+    CUVTcpServer* tcpServer = worker->server;
+
+    deleteClientHandle(request->clientHandle);
+    delete request;
+
+    if (status == 0) {
+        return;
+    }
+
+    worker->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+    // 管道随服务器停止关闭时不报告
+    if (status != UV_ECANCELED && tcpServer->m_clientConnectCallback) {
+        tcpServer->m_clientConnectCallback(Address{"", 0, 0}, // 无效地址
+                                           false,
+                                           "CUVTcpServer: Failed to hand off connection: "
+                                               + std::string(uv_strerror(status)));
+    }
+}
+
+void CUVTcpServer::onHandOffAlloc(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf)
+{
+    (void) handle;
+    (void) suggestedSize;
+    // 移交管道上只传接受时间戳，数据量很小
+    static thread_local char buffer[256];
+    *buf = uv_buf_init(buffer, sizeof(buffer));
+}
+
+// 在工作分片所在循环中接受移交管道上的TCP句柄
+void CUVTcpServer::onHandOffRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
+{
+    Shard* worker = static_cast<Shard*>(stream->data);
+    CUVTcpServer* tcpServer = worker->server;
+    uv_pipe_t* receiver = reinterpret_cast<uv_pipe_t*>(stream);
+
+    // 接收分片关闭了管道
+    if (nread < 0) {
+        closeHandOffPipes(worker);
+        return;
+    }
+    worker->handoffPending.append(buf->base, static_cast<size_t>(nread));
 
-        // 创建客户端上下文
-        ClientContext* clientCtx = new ClientContext{tcpServer, address, clientHandle, timeoutTimer};
+    // 每个句柄都附带一个接受时间戳，两者都到齐才接受
+    size_t offset = 0;
+    while (worker->handoffPending.size() - offset >= sizeof(uint64_t)
+           && uv_pipe_pending_type(receiver) == UV_TCP) {
+        uint64_t acceptTime;
+        std::memcpy(&acceptTime, worker->handoffPending.data() + offset, sizeof(acceptTime));
+        offset += sizeof(acceptTime);
+
+        uv_tcp_t* clientHandle = new uv_tcp_t;
+        std::memset(clientHandle, 0, sizeof(uv_tcp_t));
+
+        int result = uv_tcp_init(worker->loop->getLoop(), clientHandle);
+        if (result != 0) {
+            delete clientHandle;
+        } else if ((result = uv_accept(stream, reinterpret_cast<uv_stream_t*>(clientHandle)))
+                   != 0) {
+            deleteClientHandle(clientHandle);
+        }
 
-        // 将上下文存储在句柄的data字段中
-        clientHandle->data = clientCtx;
-        if (timeoutTimer) {
-            timeoutTimer->data = clientCtx;
+        if (result != 0) {
+            worker->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+            if (tcpServer->m_clientConnectCallback) {
+                tcpServer->m_clientConnectCallback(Address{"", 0, worker->index}, // 无效地址
+                                                   false,
+                                                   "CUVTcpServer: Failed to adopt connection: "
+                                                       + std::string(uv_strerror(result)));
+            }
+            continue;
         }
 
-        // 存储客户端信息
-        tcpServer->m_clients[address] = ClientInfo{clientHandle, timeoutTimer};
+        adoptHandle(worker, clientHandle, acceptTime);
+    }
+    worker->handoffPending.erase(0, offset);
+}
 
-        // 启动接收超时定时器
-        if (timeoutTimer) {
-            uv_timer_start(timeoutTimer,
-                           onReceiveTimeout,
-                           tcpServer->m_receiveTimeoutInterval, // 延迟
-                           0);                                  // 不重复
+// 在工作分片所在循环中重新打开移交过来的套接字
+void CUVTcpServer::adoptClient(Shard* worker, uv_os_sock_t sock, uint64_t acceptTime)
+{
+    CUVTcpServer* tcpServer = worker->server;
+
+    uv_tcp_t* clientHandle = new uv_tcp_t;
+    std::memset(clientHandle, 0, sizeof(uv_tcp_t));
+
+    int result = uv_tcp_init(worker->loop->getLoop(), clientHandle);
+    if (result != 0) {
+        delete clientHandle;
+        closeSocket(sock);
+    } else if ((result = uv_tcp_open(clientHandle, sock)) != 0) {
+        closeSocket(sock);
+        deleteClientHandle(clientHandle);
+    }
+
+    if (result != 0) {
+        worker->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+        if (tcpServer->m_clientConnectCallback) {
+            tcpServer->m_clientConnectCallback(Address{"", 0, worker->index}, // 无效地址
+                                               false,
+                                               "CUVTcpServer: Failed to adopt connection: "
+                                                   + std::string(uv_strerror(result)));
         }
+        return;
+    }
 
-        uv_read_start(
-            reinterpret_cast<uv_stream_t*>(clientHandle),
-            [](uv_handle_t*, size_t suggested_size, uv_buf_t* buf) {
-                // 分配缓冲区
-                buf->base = new char[suggested_size];
-                buf->len = (ULONG) suggested_size;
-            },
-            onClientRead);
+    adoptHandle(worker, clientHandle, acceptTime);
+}
 
-    } else {
+// 在工作分片所在循环中登记移交过来的连接，并记录移交延迟
+void CUVTcpServer::adoptHandle(Shard* worker, uv_tcp_t* clientHandle, uint64_t acceptTime)
+{
+    // 服务器正在停止或排空时不再接收移交过来的连接
+    ServerState state = worker->server->m_state.load();
+    if (state == ServerState::STOPPING || state == ServerState::STOPPED) {
+        deleteClientHandle(clientHandle);
+        worker->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // 记录移交延迟
+    uint64_t latencyNs = uv_hrtime() - acceptTime;
+    worker->handoffCount.fetch_add(1, std::memory_order_relaxed);
+    worker->handoffLatencyNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    uint64_t maxNs = worker->handoffLatencyMaxNs.load(std::memory_order_relaxed);
+    while (latencyNs > maxNs
+           && !worker->handoffLatencyMaxNs.compare_exchange_weak(maxNs,
+                                                                 latencyNs,
+                                                                 std::memory_order_relaxed)) {
+    }
+
+    registerClient(worker, clientHandle);
+}
+
+// 在分片所在循环中登记已接受的客户端连接并开始读取
+void CUVTcpServer::registerClient(Shard* shard, uv_tcp_t* clientHandle)
+{
+    CUVTcpServer* tcpServer = shard->server;
+
+    // 获取客户端地址信息
+    Address address = getAddress(clientHandle);
+    address.shard = shard->index;
+
+    // 创建客户端上下文并登记到分片客户端表，槽位键与分片索引组成连接ID
+    ClientContext* clientCtx = new ClientContext{
+        tcpServer, shard, address, 0, clientHandle, {}, nullptr, {}, {}, {}, 0};
+    CUVSlotMap<ClientContext*>::Key key = shard->clients.insert(clientCtx);
+    if (key == 0) {
         if (tcpServer->m_clientConnectCallback) {
-            tcpServer->m_clientConnectCallback(Address{"", 0}, // 无效地址
+            tcpServer->m_clientConnectCallback(address,
                                                false,
-                                               "CUVTcpServer: Failed to accept new connection.");
+                                               "CUVTcpServer: Too many client connections.");
         }
 
+        delete clientCtx;
+        shard->connectionCount.fetch_sub(1, std::memory_order_relaxed);
         deleteClientHandle(clientHandle);
+        return;
+    }
+    clientCtx->id = (static_cast<uint64_t>(shard->index) << kConnectionShardShift) | key;
+    clientCtx->addr.connectionId = clientCtx->id;
+    shard->addresses[clientCtx->addr] = clientCtx->id;
+
+    // 调用外部新连接回调
+    if (tcpServer->m_clientConnectCallback) {
+        tcpServer->m_clientConnectCallback(clientCtx->addr, true, "");
     }
+
+    clientCtx->timeoutTimer.callback = onReceiveTimeout;
+    clientCtx->timeoutTimer.data = clientCtx;
+    clientCtx->flushHook.callback = onFlush;
+    clientCtx->flushHook.data = clientCtx;
+    if (CUVWorkerPool* dispatcher = tcpServer->m_receiveDispatcher.load()) {
+        clientCtx->strand = dispatcher->createStrand();
+    }
+
+    // 将上下文存储在句柄的data字段中
+    clientHandle->data = clientCtx;
+
+    shard->loop->addConnection();
+
+    // 启动接收超时定时器
+    int receiveTimeoutInterval = tcpServer->m_receiveTimeoutInterval.load();
+    if (receiveTimeoutInterval > 0) {
+        shard->loop->getTimingWheel()->schedule(&clientCtx->timeoutTimer, receiveTimeoutInterval);
+    }
+
+    uv_read_start(reinterpret_cast<uv_stream_t*>(clientHandle), onClientAlloc, onClientRead);
 }
 
 void CUVTcpServer::onClientDisconnect(uv_handle_t* handle)
@@ -430,46 +1684,70 @@ void CUVTcpServer::onClientDisconnect(uv_handle_t* handle)
     // 获取客户端上下文
     ClientContext* clientCtx = static_cast<ClientContext*>(handle->data);
     CUVTcpServer* tcpServer = clientCtx->server;
-    Address addr = clientCtx->addr;
+    Shard* shard = clientCtx->shard;
+    const Address& addr = clientCtx->addr;
+
+    // 先从客户端列表中移除，断开回调和发送回调中再向该连接发送时找不到客户端
+    if (shard->clients.erase(clientCtx->id & CUVSlotMap<ClientContext*>::kKeyMask)) {
+        shard->loop->removeConnection();
+        shard->connectionCount.fetch_sub(1, std::memory_order_relaxed);
+
+        removeAddress(shard, clientCtx);
+    }
 
-    // 调用外部断开回调
-    if (tcpServer->m_clientDisconnectCallback) {
-        tcpServer->m_clientDisconnectCallback(addr);
+    // 调用外部断开回调，卸载模式下排在该连接尚未执行的接收回调之后
+    const auto& disconnectCallback = tcpServer->m_clientDisconnectCallback;
+    if (disconnectCallback && *disconnectCallback) {
+        if (clientCtx->strand) {
+            clientCtx->strand->post([disconnectCallback, addr]() { (*disconnectCallback)(addr); });
+        } else {
+            (*disconnectCallback)(addr);
+        }
     }
 
     // 清理客户端句柄
     delete reinterpret_cast<uv_tcp_t*>(handle);
 
-    // 清理接收超时定时器
-    deleteTimeoutTimer(clientCtx->timeoutTimer);
+    // 取消接收超时定时器
+    shard->loop->getTimingWheel()->cancel(&clientCtx->timeoutTimer);
 
-    // 从客户端列表中移除
-    tcpServer->m_clients.erase(addr);
+    // 丢弃尚未写出的消息
+    discardOutbound(clientCtx);
 
     // 清理客户端上下文
     delete clientCtx;
 }
 
+// 从分片所在循环的缓冲池中取用读缓冲区，尺寸由该连接最近的读取大小决定，忽略libuv建议的64KB
+void CUVTcpServer::onClientAlloc(uv_handle_t* handle, size_t, uv_buf_t* buf)
+{
+    ClientContext* clientCtx = static_cast<ClientContext*>(handle->data);
+    size_t capacity = 0;
+    buf->base = clientCtx->shard->loop->getBufferPool()->acquire(clientCtx->readSize.next(),
+                                                                 &capacity);
+    buf->len = (decltype(uv_buf_t::len)) capacity;
+}
+
 void CUVTcpServer::onClientRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
 {
     // 获取客户端上下文
     ClientContext* clientCtx = static_cast<ClientContext*>(stream->data);
     CUVTcpServer* tcpServer = clientCtx->server;
-    Address addr = clientCtx->addr;
+    char* buffer = buf->base;
 
     if (nread > 0) {
-        // 调用外部数据接收回调
-        if (tcpServer->m_clientReceiveCallback) {
-            tcpServer->m_clientReceiveCallback(addr, std::string(buf->base, nread));
+        clientCtx->readSize.record(static_cast<size_t>(nread), buf->len);
+
+        // 调用外部数据接收回调，缓冲区的所有权转移后不再归还
+        if (deliverReceive(clientCtx, buffer, static_cast<size_t>(nread))) {
+            buffer = nullptr;
         }
 
-        // 重置接收超时定时器
-        if (clientCtx->timeoutTimer) {
-            uv_timer_stop(clientCtx->timeoutTimer);
-            uv_timer_start(clientCtx->timeoutTimer,
-                           onReceiveTimeout,
-                           tcpServer->m_receiveTimeoutInterval, // 延迟
-                           0);                                  // 不重复
+        // 重置接收超时定时器，时间轮中只更新到期时间
+        int receiveTimeoutInterval = tcpServer->m_receiveTimeoutInterval.load();
+        if (receiveTimeoutInterval > 0) {
+            clientCtx->shard->loop->getTimingWheel()->schedule(&clientCtx->timeoutTimer,
+                                                               receiveTimeoutInterval);
         }
 
     } else if (nread < 0) {
@@ -477,37 +1755,70 @@ void CUVTcpServer::onClientRead(uv_stream_t* stream, ssize_t nread, const uv_buf
         tcpServer->closeClientConnection(clientCtx->clientHandle);
     }
 
-    // 释放缓冲区
-    if (buf->base) {
-        delete[] buf->base;
-    }
+    // 归还缓冲区
+    clientCtx->shard->loop->getBufferPool()->release(buffer);
 }
 
-void CUVTcpServer::onSend(uv_write_t* req, int status)
+// 按接管缓冲区、零拷贝、std::string的顺序选择接收回调，卸载模式下投递到该连接的Strand
+bool CUVTcpServer::deliverReceive(ClientContext* clientCtx, char* data, size_t length)
 {
-    // 获取客户端上下文
-    ClientContext* clientCtx = static_cast<ClientContext*>(req->data);
     CUVTcpServer* tcpServer = clientCtx->server;
-    Address clientAddr = clientCtx->addr;
+    CUVBufferPool* bufferPool = clientCtx->shard->loop->getBufferPool();
+    ConnectionId id = clientCtx->id;
+
+    const auto& bufferCallback = tcpServer->m_clientBufferCallback;
+    if (bufferCallback && *bufferCallback) {
+        CUVBufferPool::Buffer buffer = bufferPool->adopt(data, length);
+        if (clientCtx->strand) {
+            clientCtx->strand->post([bufferCallback, id, buffer = std::move(buffer)]() mutable {
+                (*bufferCallback)(id, std::move(buffer));
+            });
+        } else {
+            (*bufferCallback)(id, std::move(buffer));
+        }
+        return true;
+    }
 
-    if (tcpServer->m_sendCallback) {
-        if (status == 0) {
-            tcpServer->m_sendCallback(clientAddr, true, "");
+    const auto& dataCallback = tcpServer->m_clientDataCallback;
+    if (dataCallback && *dataCallback) {
+        if (clientCtx->strand) {
+            // 读缓冲区随任务转交给工作线程，回调结束后在工作线程中归还
+            clientCtx->strand->post(
+                [dataCallback, id, buffer = bufferPool->adopt(data, length)]() {
+                    (*dataCallback)(id, buffer.data(), buffer.size());
+                });
+            return true;
+        }
+        (*dataCallback)(id, data, length);
+        return false;
+    }
+
+    const auto& receiveCallback = tcpServer->m_clientReceiveCallback;
+    if (receiveCallback && *receiveCallback) {
+        if (clientCtx->strand) {
+            clientCtx->strand->post(
+                [receiveCallback, addr = clientCtx->addr, data = std::string(data, length)]() {
+                    (*receiveCallback)(addr, data);
+                });
         } else {
-            tcpServer->m_sendCallback(clientAddr,
-                                      false,
-                                      "CUVTcpServer: Failed to send data: "
-                                          + std::string(uv_strerror(status)));
+            (*receiveCallback)(clientCtx->addr, std::string(data, length));
         }
     }
+    return false;
+}
 
-    delete req;
+void CUVTcpServer::onSend(uv_write_t* req, int status)
+{
+    // 一批消息一起完成，发送回调仍按消息逐条调用
+    WriteBatch* batch = static_cast<WriteBatch*>(req->data);
+    finishWrites(batch->clientCtx, batch->messages.size(), batch->bytes, status);
+    delete batch;
 }
 
-void CUVTcpServer::onReceiveTimeout(uv_timer_t* handle)
+void CUVTcpServer::onReceiveTimeout(CUVTimingWheel::Timer* timer)
 {
     // 获取客户端上下文
-    ClientContext* clientCtx = static_cast<ClientContext*>(handle->data);
+    ClientContext* clientCtx = static_cast<ClientContext*>(timer->data);
     CUVTcpServer* tcpServer = clientCtx->server;
     Address clientAddr = clientCtx->addr;
 
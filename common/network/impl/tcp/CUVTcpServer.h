@@ -2,10 +2,23 @@
 #define CUVTCPSERVER_H
 
 #include "common/network/base/CUVLoop.h"
+#include "common/network/base/CUVSlotMap.h"
+#include "common/network/base/CUVWorkerPool.h"
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+namespace Common {
+namespace Network {
+class CUVLoopPool;
+} // namespace Network
+} // namespace Common
 
 /**
  * @brief 客户端地址结构体
@@ -14,6 +27,8 @@ struct Address
 {
     std::string ip = "";
     int port = 0;
+    size_t shard = 0;          // 处理该连接的分片索引（不参与比较和哈希，手工构造时不必填写）
+    uint64_t connectionId = 0; // 连接ID，0表示无效（不参与比较和哈希），此时发送按IP和端口在各分片中查找
 
     std::string toString() const { return ip + ":" + std::to_string(port); }
 
@@ -45,9 +60,16 @@ private:
     // 回调函数定义
     static void onNewConnection(uv_stream_t* server, int status);
     static void onClientDisconnect(uv_handle_t* handle);
+    static void onClientAlloc(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf);
     static void onClientRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
     static void onSend(uv_write_t* req, int status);
-    static void onReceiveTimeout(uv_timer_t* handle);
+    static void onFlush(CUVLoop::FlushHook* hook);
+    static void onReceiveTimeout(CUVTimingWheel::Timer* timer);
+    static void onHandOffConnection(uv_stream_t* listener, int status);
+    static void onHandOffConnect(uv_connect_t* req, int status);
+    static void onHandOffWrite(uv_write_t* req, int status);
+    static void onHandOffAlloc(uv_handle_t* handle, size_t suggestedSize, uv_buf_t* buf);
+    static void onHandOffRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
 
     // 辅助函数
     template<typename Func>
@@ -55,7 +77,38 @@ private:
     bool isLoopValid() const;
     void closeClientConnection(uv_tcp_t* clientHandle) const;
     static void deleteClientHandle(uv_tcp_t* clientHandle);
-    static void deleteTimeoutTimer(uv_timer_t* timeoutTimer);
+    static void deleteServerHandle(uv_tcp_t* serverHandle);
+
+    struct Shard;
+    void listenShard(Shard* shard, const std::string& host, int port);
+    void finishShardStart(bool success);
+    void failShardStart(Shard* shard, const std::string& reason, int result);
+    void startAccepting(Shard* shard);
+    void openHandOffPipes(Shard* acceptor);
+    static void connectHandOffPipe(Shard* worker, const std::string& name);
+    static void failHandOffPipe(Shard* worker, int status);
+    static void closeHandOffPipes(Shard* shard);
+    static void registerClient(Shard* shard, uv_tcp_t* clientHandle);
+    static void handOffClient(Shard* acceptor, uv_tcp_t* clientHandle);
+    static void adoptClient(Shard* worker, uv_os_sock_t sock, uint64_t acceptTime);
+    static void adoptHandle(Shard* worker, uv_tcp_t* clientHandle, uint64_t acceptTime);
+    static void closeShard(Shard* shard);
+    Shard* shardOf(uint64_t connectionId) const;
+    Shard* leastConnectedShard() const;
+    void clearShards();
+    void closeShards();
+    void waitForShards() const;
+    bool isInShardLoopThread() const;
+    bool hasPendingSends() const;
+    bool hasPendingWrites() const;
+    void notifyIdle() const;
+    bool waitUntilIdle(bool (CUVTcpServer::*pending)() const,
+                       std::chrono::steady_clock::time_point deadline) const;
+
+    class SendTicket;
+    class LookupTicket;
+    struct AddressLookup;
+    struct HandOffRequest;
 
 public:
     // 服务器状态枚举
@@ -66,20 +119,53 @@ public:
         STOPPING  // 停止中
     };
 
+    // 监听模式枚举
+    enum class ListenMode {
+        SINGLE,    // 单个监听句柄，运行在一个事件循环上
+        REUSEPORT, // 每个分片一个SO_REUSEPORT监听句柄，由内核在分片间分配连接
+        ACCEPTOR   // 一个接收循环负责accept，再把套接字移交给连接数最少的工作分片
+    };
+
+    // 分片统计信息
+    struct ShardStats
+    {
+        size_t index;                   // 分片索引
+        size_t connections;             // 当前连接数（含移交中的连接）
+        uint64_t handoffs;              // 累计移交到该分片的连接数（仅ACCEPTOR模式）
+        uint64_t handoffLatencyAvgUs;   // 平均移交延迟，单位微秒
+        uint64_t handoffLatencyMaxUs;   // 最大移交延迟，单位微秒
+        uint64_t immediateBytes;        // 由uv_try_write直接写入套接字的字节数
+        uint64_t queuedBytes;           // 未能直接写入、进入libuv写队列的字节数
+    };
+
+    // 排空关闭报告
+    struct DrainReport
+    {
+        bool completed;           // 是否在截止时间前写完了全部数据
+        uint64_t flushedBytes;    // 排空期间成功写出的字节数
+        uint64_t droppedBytes;    // 未能写出而被丢弃的字节数（含截止时仍在排队的发送）
+        size_t closedConnections; // 关闭的连接数
+        uint64_t elapsedMs;       // 排空耗时，单位毫秒
+    };
+
+    // 连接ID：高16位为分片索引，低48位为分片客户端表的槽位键（槽位索引和代数），0表示无效；
+    // 连接关闭后槽位代数递增，旧ID不会误中复用该槽位的新连接
+    using ConnectionId = uint64_t;
+
     // 客户端上下文结构体，用于存储在libuv句柄的data字段中
     struct ClientContext
     {
         CUVTcpServer* server;
+        Shard* shard;
         Address addr;
+        ConnectionId id;
         uv_tcp_t* clientHandle;
-        uv_timer_t* timeoutTimer;
-    };
-
-    // 客户端信息结构体
-    using ClientInfo = struct
-    {
-        uv_tcp_t* handle;
-        uv_timer_t* timeoutTimer;
+        CUVTimingWheel::Timer timeoutTimer;            // 接收超时定时器，挂在分片所在循环的时间轮上
+        std::shared_ptr<CUVWorkerPool::Strand> strand; // 接收和断开回调的串行执行器（仅卸载模式）
+        CUVBufferPool::ReadSizeEstimator readSize;     // 读取大小估计，决定下一次读缓冲区的尺寸
+        CUVLoop::FlushHook flushHook;                  // 循环末尾合并写出的回调节点
+        std::vector<std::string> outbound;             // 本轮循环中排队等待合并写出的消息
+        uint64_t outboundBytes;                        // outbound中的字节数
     };
 
     // 回调类型定义
@@ -91,19 +177,84 @@ public:
     using ClientDisconnectCallback = std::function<void(const Address& clientAddr)>; // 客户端断开回调
     using ClientReceiveCallback = std::function<void(const Address& clientAddr,
                                                      const std::string& data)>; // 客户端接收数据回调
+    using ClientDataCallback = std::function<
+        void(ConnectionId id, const char* data, size_t length)>; // 零拷贝接收回调
+    using ClientBufferCallback = std::function<
+        void(ConnectionId id, CUVBufferPool::Buffer&& buffer)>; // 接管读缓冲区的接收回调
     using SendCallback = std::function<
         void(const Address& clientAddr, bool success, const std::string& error)>; // 发送回调
 
     using ReceiveTimeoutCallback = std::function<void(const Address& clientAddr)>; // 接收超时回调
 
+private:
+    // 分片结构体：一个事件循环及其上的监听句柄和客户端列表，仅在所属循环线程中访问
+    struct Shard
+    {
+        CUVTcpServer* server;               // 所属服务器
+        size_t index;                       // 分片索引
+        CUVLoop* loop;                      // 分片所在事件循环
+        uv_tcp_t* serverHandle;             // 分片监听句柄
+        CUVSlotMap<ClientContext*> clients; // 分片客户端表，键为连接ID的低48位
+        std::unordered_map<Address, ConnectionId> addresses = {}; // 客户端地址到连接ID的索引
+
+        std::atomic<size_t> connectionCount = 0;      // 连接数（跨线程读取）
+        std::atomic<uint64_t> handoffCount = 0;       // 移交次数
+        std::atomic<uint64_t> handoffLatencyNs = 0;   // 移交延迟累计，单位纳秒
+        std::atomic<uint64_t> handoffLatencyMaxNs = 0; // 最大移交延迟，单位纳秒
+
+        std::atomic<size_t> pendingSends = 0;        // 已投递但尚未执行的发送任务数
+        std::atomic<uint64_t> pendingWriteBytes = 0; // 已提交给libuv但尚未完成的写入字节数
+        std::atomic<uint64_t> flushedBytes = 0;      // 累计成功写出的字节数
+        std::atomic<uint64_t> droppedBytes = 0;      // 累计未能写出的字节数
+        std::atomic<uint64_t> immediateBytes = 0;    // 累计由uv_try_write直接写出的字节数
+        std::atomic<uint64_t> queuedBytes = 0;       // 累计进入libuv写队列的字节数
+
+        std::vector<uv_buf_t> writeBufs = {}; // 合并写出时的缓冲区描述数组，复用以免每次分配
+        std::string startError = {};          // 本次启动失败的原因，成功时为空
+
+        // 经IPC管道移交连接时使用（仅ACCEPTOR模式）
+        std::vector<uv_pipe_t*> handoffListeners = {}; // 接收分片上等待各工作分片连接的管道
+        std::vector<uv_pipe_t*> handoffSenders = {};   // 接收分片上发往各工作分片的管道
+        uv_pipe_t* handoffReceiver = nullptr;          // 工作分片上接收移交连接的管道
+        std::string handoffPending = {}; // 工作分片上已收到、尚未配上句柄的接受时间戳
+    };
+
+    // 把收到的数据交给已设置的接收回调，返回读缓冲区的所有权是否已转移
+    static bool deliverReceive(ClientContext* clientCtx, char* data, size_t length);
+
+    // 在分片所在循环中查找客户端，找不到或连接正在关闭时返回nullptr
+    static ClientContext* findClient(Shard* shard, ConnectionId id);
+
+    // 在分片所在循环中维护和查询分片的地址索引，供没有连接ID的地址查找连接
+    static void removeAddress(Shard* shard, const ClientContext* clientCtx);
+    static ConnectionId findConnection(Shard* shard, const Address& clientAddr);
+
+    // 没有连接ID的地址：投递到各分片分别查找，找到的分片按连接ID发送
+    void sendByAddress(const Address& clientAddr, std::string&& data);
+
+    // 在分片所在循环中把数据放入客户端的发送队列，本轮循环末尾合并写出
+    void writeClient(ClientContext* clientCtx, std::string&& data, SendTicket& ticket);
+
+    // 统计一批消息的写出结果，并按消息逐条调用发送回调
+    static void finishWrites(ClientContext* clientCtx, size_t count, uint64_t bytes, int status);
+
+    // 连接关闭时丢弃发送队列中尚未写出的消息，调用前客户端必须已从客户端表中移除
+    static void discardOutbound(ClientContext* clientCtx);
+
 public:
     /**
      * @brief 构造函数
+     * @details 注入的事件循环和循环池必须比服务器存活更久
+     * @param loop 主事件循环（SINGLE模式的监听循环、ACCEPTOR模式的接收循环），
+     *             nullptr表示从循环池中轮询选择
+     * @param loopPool 分片所用的事件循环池，nullptr表示使用全局默认循环池
      */
-    explicit CUVTcpServer();
+    explicit CUVTcpServer(CUVLoop* loop = nullptr, CUVLoopPool* loopPool = nullptr);
 
     /**
      * @brief 析构函数
+     * @details 前置条件：不能在分片所在的事件循环线程中析构（例如在回调中删除服务器），
+     *          调试版本中断言检查；可以在回调中调用stop()，再在其他线程中析构
      */
     ~CUVTcpServer();
 
@@ -116,23 +267,100 @@ public:
 public:
     /**
      * @brief 启动服务器并监听指定地址和端口
+     * @details 监听在分片所在的事件循环中进行，REUSEPORT模式下各分片并发启动；
+     *          全部分片完成后在最后完成的分片所在循环线程中只调用一次启动回调，
+     *          至少一个分片监听成功即视为启动成功，信息中附带成功的分片数和各分片的失败原因
      * @param host 监听地址
      * @param port 监听端口
      */
     void listen(const std::string& host, int port);
 
+    /**
+     * @brief 设置监听模式，仅在服务器停止时有效
+     * @details REUSEPORT模式下每个分片在各自的事件循环上打开一个SO_REUSEPORT监听套接字，
+     *          由内核将新连接分散到各个分片，每个分片独立维护自己的客户端列表；
+     *          该模式依赖SO_REUSEPORT，在Windows上启动会失败；
+     *          ACCEPTOR模式下由主事件循环接受连接，再按最少连接数把套接字移交给工作分片，
+     *          适用于少量NAT网关后面挂大量设备、SO_REUSEPORT哈希严重倾斜的场景；
+     *          Windows上经每个工作分片一条的IPC管道（uv_write2）移交，其他平台直接移交复制的套接字
+     * @param mode 监听模式
+     * @param shardCount 分片（工作分片）数量，0表示使用循环池中的全部循环
+     */
+    void setListenMode(ListenMode mode, size_t shardCount = 0);
+
+    /**
+     * @brief 获取分片数量
+     * @return 分片数量
+     */
+    size_t getShardCount() const;
+
+    /**
+     * @brief 获取各分片的连接数、移交延迟和直接写出/排队写出字节数统计
+     * @return 分片统计信息列表
+     */
+    std::vector<ShardStats> getShardStats() const;
+
     /**
      * @brief 停止服务器
+     * @details 立即关闭监听句柄和全部连接，仍在写队列中的数据被丢弃；
+     *          在非事件循环线程中调用时，等待各分片关闭完成后返回
      */
     void stop();
 
+    /**
+     * @brief 排空后停止服务器，用于滚动重启
+     * @details 先停止接受新连接，已建立的连接继续收发；等待已投递的发送任务和libuv写请求完成，
+     *          直到全部写出或超过截止时间，再关闭全部连接，此时仍未写出的数据计为丢弃；
+     *          阻塞调用线程，在事件循环线程中调用时不等待写出
+     * @param timeoutMs 等待写出的最长时间，单位毫秒
+     * @return 排空报告，服务器未在运行时completed为false且其余字段为0
+     */
+    DrainReport drain(uint64_t timeoutMs);
+
     /**
      * @brief 发送数据到指定客户端
+     * @details 地址带有连接ID时（回调中传入的地址）按连接ID发送；
+     *          否则投递到每个分片，在各分片自己的地址索引中按IP和端口查找，找到的分片再按连接ID发送；
+     *          同一连接在一轮循环中的多次发送在循环末尾合并，先用uv_try_write直接写入套接字，
+     *          只有未写完的部分进入libuv写队列；发送回调仍按消息逐条调用；
+     *          在分片所在循环线程中调用时不经过任务队列；发送任务被拒绝、被DROP_OLDEST策略
+     *          挤出队列或随事件循环停止而丢弃时，在销毁任务的线程中以失败调用发送回调
      * @param clientAddr 客户端地址
      * @param data 要发送的数据
      */
     void send(const Address& clientAddr, const std::string& data);
 
+    /**
+     * @brief 发送数据到指定客户端（右值版本，负载直接移动到写请求中）
+     * @param clientAddr 客户端地址
+     * @param data 要发送的数据
+     */
+    void send(const Address& clientAddr, std::string&& data);
+
+    /**
+     * @brief 按连接ID发送数据
+     * @details 由连接ID直接得到分片，在分片客户端表中O(1)查找，不哈希字符串、不拷贝地址；
+     *          连接已关闭（ID过期）时发送回调报告找不到客户端，回调中的地址只有分片索引和连接ID
+     * @param id 连接ID
+     * @param data 要发送的数据
+     */
+    void send(ConnectionId id, const std::string& data);
+
+    /**
+     * @brief 按连接ID发送数据（右值版本，负载直接移动到写请求中）
+     * @param id 连接ID
+     * @param data 要发送的数据
+     */
+    void send(ConnectionId id, std::string&& data);
+
+    /**
+     * @brief 按连接ID查询客户端地址
+     * @details 在连接所在分片的事件循环中查找，在其他线程中调用时阻塞等待查找完成
+     * @param id 连接ID
+     * @return 客户端地址，连接不存在时ip为空、connectionId为0
+     */
+    Address getClientAddress(ConnectionId id) const;
+
     /**
      * @brief 获取服务器当前状态
      * @return 服务器状态
@@ -153,26 +381,70 @@ public:
     void setSendCallback(SendCallback&& callback);                     // 设置发送回调
     void setReceiveTimeoutCallback(ReceiveTimeoutCallback&& callback); // 设置接收超时回调
 
+    /**
+     * @brief 设置零拷贝接收回调，设置后替代setReceiveCallback()设置的回调
+     * @details 回调直接收到读缓冲区的指针和长度以及连接ID，不构造std::string、不拷贝Address；
+     *          数据只在回调期间有效；卸载模式下读缓冲区随任务转交给工作线程，同样不拷贝；
+     *          连接ID可在连接回调的Address::connectionId中得到
+     * @param callback 回调函数
+     */
+    void setDataCallback(ClientDataCallback&& callback);
+
+    /**
+     * @brief 设置接管读缓冲区的接收回调，设置后替代其余两种接收回调
+     * @details 回调取得池化读缓冲区的所有权，可以把它保存或转交给其他线程继续处理而不拷贝，
+     *          CUVBufferPool::Buffer销毁时缓冲区归还到所属事件循环的缓冲池；
+     *          长期持有缓冲区会增加缓冲池的驻留字节数
+     * @param callback 回调函数
+     */
+    void setBufferCallback(ClientBufferCallback&& callback);
+
+    /**
+     * @brief 设置接收回调的卸载线程池
+     * @details 设置后，新建立连接的接收回调和断开回调不再在事件循环线程中执行，
+     *          而是投递到该连接在线程池中的Strand上：同一连接的回调按顺序串行执行，
+     *          不同连接的回调并行执行；其余回调仍在事件循环线程中执行；
+     *          仅对之后建立的连接生效，nullptr表示恢复在事件循环线程中执行；
+     *          线程池必须比服务器存活更久
+     * @param pool 工作线程池
+     */
+    void setReceiveDispatcher(CUVWorkerPool* pool);
+
 private:
-    CUVLoop* m_loop;                  // 事件循环
-    uv_tcp_t* m_serverHandle;         // 服务器TCP句柄
+    CUVLoop* m_loop;                  // 主事件循环（SINGLE模式）
+    CUVLoopPool* m_loopPool;          // 分片所用的事件循环池
     std::atomic<ServerState> m_state; // 服务器状态
 
+    ListenMode m_listenMode;             // 监听模式
+    std::vector<Shard*> m_shards;        // 分片列表
+    Shard* m_acceptor;                   // 接收分片（仅ACCEPTOR模式）
+    std::atomic<size_t> m_pendingShards; // 尚未完成启动的分片数
+    std::atomic<size_t> m_startedShards; // 启动成功的分片数
+
     Address m_listenAddress; // 监听地址
     size_t m_maxConnections; // 最大连接数
 
-    int m_receiveTimeoutInterval; // 接收超时间隔
+    std::atomic<int> m_receiveTimeoutInterval; // 接收超时间隔
 
-    std::unordered_map<Address, ClientInfo> m_clients; // 客户端列表
+    std::atomic<CUVWorkerPool*> m_receiveDispatcher; // 接收回调的卸载线程池，nullptr表示不卸载
+
+    // 排空和停止时等待发送任务与写入完成，只有存在等待者时分片循环才会加锁唤醒
+    mutable std::mutex m_idleMutex;
+    mutable std::condition_variable m_idleCond;
+    mutable std::atomic<size_t> m_idleWaiters;
 
     // 回调函数
     ServerStartCallback m_serverStartCallback;           // 服务器启动回调
     ServerStopCallback m_serverStopCallback;             // 服务器停止回调
     ClientConnectCallback m_clientConnectCallback;       // 客户端连接回调
-    ClientDisconnectCallback m_clientDisconnectCallback; // 客户端断开回调
-    ClientReceiveCallback m_clientReceiveCallback;       // 客户端接收数据回调
     SendCallback m_sendCallback;                         // 发送回调
     ReceiveTimeoutCallback m_receiveTimeoutCallback;     // 接收超时回调
+
+    // 接收和断开回调由卸载任务共享持有，服务器销毁后仍在排队的回调可以安全执行
+    std::shared_ptr<const ClientDisconnectCallback> m_clientDisconnectCallback; // 客户端断开回调
+    std::shared_ptr<const ClientReceiveCallback> m_clientReceiveCallback;       // 客户端接收数据回调
+    std::shared_ptr<const ClientDataCallback> m_clientDataCallback;             // 零拷贝接收回调
+    std::shared_ptr<const ClientBufferCallback> m_clientBufferCallback;         // 接管缓冲区的接收回调
 };
 
 } // namespace Network
@@ -6,6 +6,14 @@
 #include "common/network/impl/tcp/CUVTcpClient.h"
 #include "common/network/impl/tcp/CUVTcpServer.h"
 
+#ifdef NETWORK_BENCHMARK
+#include "bench/NetworkBenchmark.h"
+#endif
+
+#ifdef NETWORK_TEST
+#include "test/NetworkUnitTest.h"
+#endif
+
 #include <iostream>
 
 #ifdef _WIN32
@@ -315,6 +323,13 @@ int main(int argc, char* argv[])
     QCoreApplication a(argc, argv);
     int ret = 0;
 
+#ifdef NETWORK_TEST
+    // 运行基础数据结构测试，失败时直接退出
+    if (testTask() != 0 || testSlotMap() != 0 || testTimingWheel() != 0) {
+        return 1;
+    }
+#endif
+
     // 运行MQTT测试
     testMQTT();
 
@@ -324,6 +339,38 @@ int main(int argc, char* argv[])
     // 运行TCP服务器测试
     // testTcpServer();
 
+#ifdef NETWORK_BENCHMARK
+    // 运行任务投递分配基准测试
+    // benchTaskAllocation();
+
+    // 运行生产者令牌基准测试
+    // benchProducerToken();
+
+    // 运行有返回值任务提交基准测试
+    // benchSubmit();
+
+    // 运行跨循环通道基准测试
+    // benchChannel();
+
+    // 运行读缓冲池基准测试
+    // benchReadBuffer();
+
+    // 运行服务器接收路径基准测试
+    // benchReceivePath();
+
+    // 运行连接查找基准测试
+    // benchConnectionLookup();
+
+    // 运行合并写出基准测试
+    // benchWriteCoalescing();
+
+    // 运行请求应答往返基准测试
+    // benchRequestResponse();
+
+    // 运行忙轮询唤醒延迟基准测试
+    // benchBusyPoll();
+#endif
+
     QTimer::singleShot(5 * 1000, &a, &QCoreApplication::quit);
     ret = a.exec();
     return ret;
@@ -0,0 +1,230 @@
+#include "NetworkUnitTest.h"
+
+#include "common/network/base/CUVSlotMap.h"
+#include "common/network/base/CUVTask.h"
+#include "common/network/base/CUVTimingWheel.h"
+
+#include <functional>
+#include <iostream>
+#include <utility>
+
+// 测试断言：条件不成立时输出失败信息
+static bool check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cout << "FAILED: " << what << std::endl;
+    }
+    return condition;
+}
+
+// 记录构造、移动、析构和调用次数的可调用对象，PadSize决定CUVTask内联存放还是堆分配
+template<size_t PadSize>
+struct TaskProbe
+{
+    int* alive;
+    int* moves;
+    int* calls;
+    char pad[PadSize] = {};
+
+    TaskProbe(int* alive, int* moves, int* calls)
+        : alive(alive)
+        , moves(moves)
+        , calls(calls)
+    {
+        ++*alive;
+    }
+    TaskProbe(TaskProbe&& other) noexcept
+        : alive(other.alive)
+        , moves(other.moves)
+        , calls(other.calls)
+    {
+        ++*alive;
+        ++*moves;
+    }
+    ~TaskProbe() { --*alive; }
+
+    void operator()() { ++*calls; }
+};
+
+// 内联任务移动时移动可调用对象，堆任务只转移指针
+template<size_t PadSize>
+bool testTaskStorage(bool expectInline)
+{
+    using namespace Common::Network;
+    using Probe = TaskProbe<PadSize>;
+
+    bool ok = true;
+    int alive = 0;
+    int moves = 0;
+    int calls = 0;
+    {
+        CUVTask task(Probe(&alive, &moves, &calls));
+        ok &= check(task && alive == 1 && moves == 1, "task holds exactly one callable");
+
+        CUVTask moved(std::move(task));
+        ok &= check(!task && moved && alive == 1, "move construction transfers the callable");
+        ok &= check(moves == (expectInline ? 2 : 1), "inline tasks move the callable, heap tasks do not");
+
+        task();
+        moved();
+        ok &= check(calls == 1, "only the moved-to task invokes the callable");
+
+        CUVTask other(Probe(&alive, &moves, &calls));
+        other = std::move(moved);
+        ok &= check(!moved && other && alive == 1, "move assignment destroys the replaced callable");
+        other();
+        ok &= check(calls == 2, "move-assigned task invokes the callable");
+
+        other.reset();
+        ok &= check(!other && alive == 0, "reset destroys the callable");
+
+        CUVTask dropped(Probe(&alive, &moves, &calls));
+    }
+    ok &= check(alive == 0 && calls == 2, "destroying a task destroys its callable without calling it");
+    return ok;
+}
+
+int testTask()
+{
+    using namespace Common::Network;
+
+    bool ok = testTaskStorage<16>(true);
+    ok &= testTaskStorage<CUVTask::kInlineSize>(false);
+
+    CUVTask emptyFunction{std::function<void()>()};
+    CUVTask emptyPointer{static_cast<void (*)()>(nullptr)};
+    ok &= check(!emptyFunction && !emptyPointer, "empty callables make empty tasks");
+
+    std::cout << "testTask " << (ok ? "passed" : "failed") << std::endl;
+    return ok ? 0 : -1;
+}
+
+int testSlotMap()
+{
+    using namespace Common::Network;
+    using SlotMap = CUVSlotMap<int>;
+    const SlotMap::Key indexMask = (SlotMap::Key(1) << SlotMap::kIndexBits) - 1;
+
+    bool ok = true;
+    SlotMap map;
+    SlotMap::Key a = map.insert(1);
+    SlotMap::Key b = map.insert(2);
+    SlotMap::Key c = map.insert(3);
+    ok &= check(a != 0 && b != 0 && c != 0 && a != b && b != c, "keys are distinct and non-zero");
+    ok &= check(*map.find(a) == 1 && *map.find(b) == 2 && *map.find(c) == 3, "keys find their values");
+
+    // 删除后旧键失效，与末尾元素交换后其他键仍然有效
+    ok &= check(map.erase(a), "erase a live key");
+    ok &= check(!map.find(a) && !map.erase(a), "erased key is stale");
+    ok &= check(*map.find(b) == 2 && *map.find(c) == 3, "erase keeps other keys valid");
+
+    // 复用槽位时代数加一，旧键不会误中新元素
+    SlotMap::Key d = map.insert(4);
+    ok &= check((d & indexMask) == (a & indexMask) && d != a, "reused slot gets a new generation");
+    ok &= check(!map.find(a) && *map.find(d) == 4, "stale key does not find the new value");
+
+    ok &= check(!map.find(0), "key 0 is never valid");
+    ok &= check(!map.find(d | (SlotMap::Key(1) << (SlotMap::kIndexBits + SlotMap::kGenerationBits))),
+                "bits above the key mask are rejected");
+
+    // 空闲槽位先进先出复用
+    map.erase(b);
+    map.erase(c);
+    SlotMap::Key e = map.insert(5);
+    ok &= check((e & indexMask) == (b & indexMask), "free slots are reused in FIFO order");
+
+    map.clear();
+    ok &= check(map.empty() && !map.find(d) && !map.find(e), "clear invalidates all keys");
+
+    // 同一槽位反复复用：代数取遍全部非零值后才回绕到1，跳过0
+    SlotMap single;
+    const SlotMap::Key first = single.insert(0);
+    const uint32_t generations = (uint32_t(1) << SlotMap::kGenerationBits) - 1;
+    SlotMap::Key key = first;
+    bool distinct = true;
+    for (uint32_t i = 1; i < generations; ++i) {
+        single.erase(key);
+        key = single.insert(static_cast<int>(i));
+        distinct &= key != 0 && key != first;
+    }
+    ok &= check(distinct, "keys stay non-zero and distinct until the generation wraps");
+    ok &= check((key >> SlotMap::kIndexBits) == generations, "last generation before wraparound");
+    single.erase(key);
+    key = single.insert(0);
+    ok &= check(key == first, "generation wraps around to 1, skipping 0");
+
+    std::cout << "testSlotMap " << (ok ? "passed" : "failed") << std::endl;
+    return ok ? 0 : -1;
+}
+
+int testTimingWheel()
+{
+    using namespace Common::Network;
+
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    CUVTimingWheel wheel;
+    wheel.init(&loop);
+
+    // 记录触发次数和相对开始时刻的触发时间
+    struct Probe
+    {
+        CUVTimingWheel::Timer timer;
+        uv_loop_t* loop = nullptr;
+        uint64_t start = 0;
+        int fired = 0;
+        uint64_t firedAt = 0;
+    };
+    uint64_t start = uv_now(&loop);
+    Probe cascaded, postponed, advanced, cancelled;
+    for (Probe* probe : {&cascaded, &postponed, &advanced, &cancelled}) {
+        probe->loop = &loop;
+        probe->start = start;
+        probe->timer.data = probe;
+        probe->timer.callback = [](CUVTimingWheel::Timer* timer) {
+            Probe* probe = static_cast<Probe*>(timer->data);
+            ++probe->fired;
+            probe->firedAt = uv_now(probe->loop) - probe->start;
+        };
+    }
+
+    // 超出第0层256毫秒的定时器经重新分层才触发
+    wheel.schedule(&cascaded.timer, 300);
+    // 延后：只更新到期时间，到达原槽位时重新插入
+    wheel.schedule(&postponed.timer, 50);
+    wheel.schedule(&postponed.timer, 400);
+    // 提前：从原槽位移到更早的槽位
+    wheel.schedule(&advanced.timer, 500);
+    wheel.schedule(&advanced.timer, 20);
+    // 取消后不再触发
+    wheel.schedule(&cancelled.timer, 30);
+    wheel.cancel(&cancelled.timer);
+
+    bool ok = check(wheel.size() == 3, "cancelled timer is not counted");
+
+    // 时间轮的驱动定时器不阻止循环退出，由另一个定时器维持循环运行到全部到期之后
+    uv_timer_t stopper;
+    uv_timer_init(&loop, &stopper);
+    stopper.data = &wheel;
+    uv_timer_start(
+        &stopper,
+        [](uv_timer_t* handle) {
+            static_cast<CUVTimingWheel*>(handle->data)->close();
+            uv_close(reinterpret_cast<uv_handle_t*>(handle), nullptr);
+        },
+        700,
+        0);
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+
+    ok &= check(cascaded.fired == 1 && cascaded.firedAt >= 300, "cascaded timer fires once, on time");
+    ok &= check(postponed.fired == 1 && postponed.firedAt >= 400, "postponed timer fires at its new time");
+    ok &= check(advanced.fired == 1 && advanced.firedAt >= 20 && advanced.firedAt < 500,
+                "advanced timer fires at its new time");
+    ok &= check(cancelled.fired == 0, "cancelled timer does not fire");
+    ok &= check(wheel.size() == 0 && !CUVTimingWheel::isScheduled(&cascaded.timer),
+                "fired timers are unscheduled");
+
+    std::cout << "testTimingWheel " << (ok ? "passed" : "failed") << std::endl;
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,11 @@
+#ifndef NETWORKUNITTEST_H
+#define NETWORKUNITTEST_H
+
+// 基础数据结构测试，仅在qmake CONFIG+=network_test时编译，默认启动时不运行；
+// 返回0表示通过
+
+int testTask();        // 小对象任务
+int testSlotMap();     // 代际槽位表
+int testTimingWheel(); // 分层时间轮
+
+#endif // NETWORKUNITTEST_H